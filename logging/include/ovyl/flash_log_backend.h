@@ -16,6 +16,13 @@
 extern "C" {
 #endif
 
+#include <zephyr/logging/log_backend.h>
+
+/**
+ * @brief Flash log backend instance, e.g. for log_filter_set() on this backend only.
+ */
+const struct log_backend *ovyl_flash_log_backend_get(void);
+
 #ifdef __cplusplus
 }
 #endif
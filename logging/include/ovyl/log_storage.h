@@ -7,6 +7,11 @@
 /**
  * @file log_storage.h
  * @brief Flash-backed log storage interface.
+ *
+ * Implemented on an FCB partition by default. With
+ * CONFIG_OVYL_LOG_STORAGE_BACKEND_LITTLEFS the logs are kept as one file per
+ * boot instead; that backend stores a plain byte stream, so the entry, record
+ * and time based features of the FCB backend are not available.
  */
 
 #ifndef OVYL_LOG_STORAGE_H
@@ -18,7 +23,116 @@ extern "C" {
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <zephyr/fs/fcb.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+#endif
+
+/** @brief Bulk read flag: prefix each entry with its little-endian 16-bit length. */
+#define OVYL_LOG_STORAGE_BULK_ENTRY_HDR (1U << 0)
+
+/** @brief Size of the per-entry header added by OVYL_LOG_STORAGE_BULK_ENTRY_HDR. */
+#define OVYL_LOG_STORAGE_BULK_HDR_SIZE (2U)
+
+/** @brief Export filter flag: start at the sector holding since_boot/since_ms. */
+#define OVYL_LOG_STORAGE_FILTER_SINCE (1U << 1)
+
+/** @brief Export filter flag: stop at the first sector started after until_boot/until_ms. */
+#define OVYL_LOG_STORAGE_FILTER_UNTIL (1U << 2)
+
+/** @brief Export filter flag: keep records at or above the severity in max_level. */
+#define OVYL_LOG_STORAGE_FILTER_LEVEL (1U << 3)
+
+/** @brief Export filter flag: keep records from the log sources listed in sources. */
+#define OVYL_LOG_STORAGE_FILTER_SOURCE (1U << 4)
+
+/** @brief Export filter flag: keep entries written during the boot session in boot. */
+#define OVYL_LOG_STORAGE_FILTER_BOOT (1U << 5)
+
+/** @brief Maximum number of log sources an export filter can select. */
+#define OVYL_LOG_STORAGE_FILTER_MAX_SOURCES 4U
+
+/** @brief Size of the structured header in front of every stored log record. */
+#define OVYL_LOG_STORAGE_RECORD_HDR_SIZE 20U
+
+/** @brief First byte of every record header, used to resynchronize a stream. */
+#define OVYL_LOG_STORAGE_RECORD_SYNC 0xA5U
+
+/** @brief Record flag: the payload continues the previous record with the same sequence number. */
+#define OVYL_LOG_STORAGE_RECORD_CONT (1U << 0)
+
+/** @brief Source id of records not tied to a log module (printk, dropped notices). */
+#define OVYL_LOG_STORAGE_RECORD_NO_SOURCE 0xFFFFU
+
+/** @brief Size of the header FCB writes at the start of every sector. */
+#define OVYL_LOG_STORAGE_SECTOR_HDR_SIZE (8U)
+
+/**
+ * @brief Persistable position inside the flash circular buffer.
+ *
+ * Sectors are referenced by index and carry a copy of their on-flash header so
+ * a stale position (sector erased or reused since) can be detected on boot.
+ */
+typedef struct ovyl_log_storage_position_t {
+    uint32_t elem_off;                                   /**< Offset within the sector. */
+    uint8_t sector_idx;                                  /**< Index into the partition's sectors. */
+    uint8_t sector_hdr[OVYL_LOG_STORAGE_SECTOR_HDR_SIZE]; /**< FCB sector header when the position was taken. */
+} ovyl_log_storage_position_t;
+
+/**
+ * @brief Operations of an export destination (shell, UART, BLE, file, ...).
+ *
+ * Only @c write is mandatory.
+ */
+typedef struct ovyl_log_storage_sink_api {
+    /** Consume @p len bytes; return 0 or a negative errno to abort the export. */
+    int (*write)(void *ctx, const uint8_t *data, size_t len);
+    /** Push out buffered data once the export completes. */
+    int (*flush)(void *ctx);
+    /** Bytes the sink can accept right now; 0 pauses the export. */
+    size_t (*credit)(void *ctx);
+} ovyl_log_storage_sink_api_t;
+
+/** @brief Export destination passed to ovyl_log_storage_export(). */
+typedef struct ovyl_log_storage_sink {
+    const ovyl_log_storage_sink_api_t *api; /**< Sink operations. */
+    void *ctx;                              /**< Passed back to every operation. */
+} ovyl_log_storage_sink_t;
+
+/** @brief Selection and framing options for ovyl_log_storage_export(). */
+typedef struct ovyl_log_storage_filter {
+    uint32_t flags;      /**< OVYL_LOG_STORAGE_BULK_ENTRY_HDR and OVYL_LOG_STORAGE_FILTER_* bits. */
+    uint16_t since_boot; /**< Boot id used with OVYL_LOG_STORAGE_FILTER_SINCE. */
+    uint16_t until_boot; /**< Boot id used with OVYL_LOG_STORAGE_FILTER_UNTIL. */
+    uint64_t since_ms;   /**< Uptime used with OVYL_LOG_STORAGE_FILTER_SINCE. */
+    uint64_t until_ms;   /**< Uptime used with OVYL_LOG_STORAGE_FILTER_UNTIL. */
+    uint16_t boot;       /**< Boot id used with OVYL_LOG_STORAGE_FILTER_BOOT. */
+    uint8_t max_level;   /**< Most verbose level kept with OVYL_LOG_STORAGE_FILTER_LEVEL (LOG_LEVEL_ERR..DBG). */
+    uint8_t source_cnt;  /**< Number of valid entries in sources. */
+    uint16_t sources[OVYL_LOG_STORAGE_FILTER_MAX_SOURCES]; /**< Local domain source ids used with OVYL_LOG_STORAGE_FILTER_SOURCE. */
+} ovyl_log_storage_filter_t;
+
+/**
+ * @brief Decoded record header (CONFIG_OVYL_LOG_STORAGE_RECORD_HDR).
+ *
+ * On flash the header is OVYL_LOG_STORAGE_RECORD_HDR_SIZE bytes, little endian:
+ * sync (u8), level (u8, low 3 bits) | flags << 3, source id (u16), boot id
+ * (u16), payload length (u16), sequence number (u32), timestamp (u64).
+ */
+typedef struct ovyl_log_storage_record_hdr {
+    uint64_t timestamp; /**< Raw log timestamp of the message. */
+    uint32_t seq;       /**< Per-boot sequence number, assigned when stored. */
+    uint16_t boot_id;   /**< Boot session, see ovyl_log_storage_boot_id(). */
+    uint16_t source_id; /**< Local domain source id or OVYL_LOG_STORAGE_RECORD_NO_SOURCE. */
+    uint16_t len;       /**< Payload bytes following the header. */
+    uint8_t level;      /**< Zephyr log level (LOG_LEVEL_ERR..DBG, 0 when none). */
+    uint8_t flags;      /**< OVYL_LOG_STORAGE_RECORD_* flags. */
+} ovyl_log_storage_record_hdr_t;
+
+/** @brief Independent read position obtained from ovyl_log_storage_cursor_open(). */
+typedef struct ovyl_log_storage_cursor ovyl_log_storage_cursor_t;
 
 /**
  * @brief Metadata persisted alongside the flash circular buffer.
@@ -32,14 +146,121 @@ typedef struct ovyl_log_storage_metadata_t {
     struct fcb_entry tail;   /**< Cached tail entry for the ring buffer. */
 } ovyl_log_storage_metadata_t;
 
+/**
+ * @brief Runtime counters reported by the log storage module.
+ */
+typedef struct ovyl_log_storage_stats_t {
+    uint32_t staging_flushes;            /**< Staged buffers written to flash. */
+    uint32_t staging_entries_saved;      /**< FCB entries avoided by coalescing appends. */
+    uint32_t staging_bytes_saved;        /**< FCB header/CRC/padding bytes avoided. */
+    uint32_t staging_last_entries_saved; /**< Entries avoided by the most recent flush. */
+    uint32_t staging_last_bytes_saved;   /**< Bytes avoided by the most recent flush. */
+    uint32_t async_high_water;           /**< Maximum ring slots in use at once. */
+    uint32_t async_dropped;              /**< Ring messages discarded due to overflow. */
+    uint32_t append_max_us_erase_ahead;  /**< Worst FCB append latency with erase-ahead on. */
+    uint32_t append_max_us_inline;       /**< Worst FCB append latency with erase-ahead off. */
+    uint32_t program_ops;                /**< Flash program operations issued for main-log entries. */
+    uint32_t program_bytes;              /**< Log bytes stored by those entries. */
+    uint32_t inline_rotations;           /**< Sector erases performed inside an append. */
+    uint32_t erase_ahead_erases;         /**< Sectors erased ahead of time by the work item. */
+    uint32_t compress_bytes_in;          /**< Uncompressed bytes handed to the compressor. */
+    uint32_t compress_bytes_out;         /**< Bytes written to flash after compression. */
+    uint32_t compress_us;                /**< Total CPU time spent compressing. */
+    uint32_t decompress_us;              /**< Total CPU time spent decompressing on export. */
+    uint32_t export_dropped;             /**< Writes dropped because rotation would erase unexported data. */
+    uint32_t export_bytes;               /**< Bytes streamed by the last ovyl_log_storage_export(). */
+    uint32_t export_us;                  /**< Duration of the last ovyl_log_storage_export(). */
+    uint32_t export_filtered;            /**< Bytes the last ovyl_log_storage_export() filtered out. */
+    uint32_t read_ahead_fills;           /**< Flash reads issued to refill the read-ahead window. */
+    uint32_t read_ahead_hits;            /**< Entry reads served from the read-ahead window. */
+    uint32_t lane_records;               /**< Records written to the high-severity priority lane. */
+    uint32_t panic_recovered;            /**< Bytes copied from the panic region at init. */
+    uint32_t init_us;                    /**< Duration of ovyl_log_storage_init(). */
+} ovyl_log_storage_stats_t;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB
+/**
+ * @brief Entries in the partition's sector table.
+ *
+ * CONFIG_OVYL_LOG_STORAGE_MAX_SECTORS, or one per
+ * CONFIG_OVYL_LOG_STORAGE_MIN_SECTOR_SIZE bytes of the partition (4 to 255)
+ * when that is 0.
+ */
+#if CONFIG_OVYL_LOG_STORAGE_MAX_SECTORS > 0
+#define OVYL_LOG_STORAGE_NUM_SECTORS CONFIG_OVYL_LOG_STORAGE_MAX_SECTORS
+#else
+#define OVYL_LOG_STORAGE_NUM_SECTORS                                                               \
+    CLAMP(FIXED_PARTITION_SIZE(logging_storage) / CONFIG_OVYL_LOG_STORAGE_MIN_SECTOR_SIZE, 4U, 255U)
+#endif
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+/**
+ * @brief Flash wear record persisted through Ovyl Config (CONFIG_OVYL_LOG_STORAGE_WEAR).
+ *
+ * Erase counts are indexed like the partition's sector table, which covers
+ * the main log, the priority lane and the panic region. The record is
+ * discarded when the table no longer has @c sector_cnt sectors.
+ */
+typedef struct ovyl_log_storage_wear_t {
+    uint32_t magic;                                      /**< Magic word indicating a valid record. */
+    uint32_t minutes;                                    /**< Powered-on minutes accounted so far. */
+    uint64_t bytes;                                      /**< Bytes written to log and lane sectors, FCB overhead included. */
+    uint8_t sector_cnt;                                  /**< Sector count the erases were counted with. */
+    uint32_t erases[OVYL_LOG_STORAGE_NUM_SECTORS];       /**< Erase count of every sector. */
+} ovyl_log_storage_wear_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+/**
+ * @brief Per-module log level overrides persisted through Ovyl Config.
+ *
+ * Modules are keyed by the 32-bit FNV-1a hash of their name, kept sorted so
+ * boot applies every override in one pass over the log sources. Levels are
+ * packed two bits per override as level - LOG_LEVEL_ERR.
+ */
+typedef struct ovyl_log_storage_module_levels_t {
+    uint8_t count;                                                    /**< Overrides in use. */
+    uint8_t levels[(CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS_MAX + 3) / 4]; /**< Packed 2-bit levels. */
+    uint32_t hashes[CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS_MAX];       /**< Sorted module name hashes. */
+} ovyl_log_storage_module_levels_t;
+#endif
+
+/** @brief Write-budget governor state. */
+typedef enum {
+    OVYL_LOG_STORAGE_WEAR_NORMAL = 0, /**< Within budget; every level is stored. */
+    OVYL_LOG_STORAGE_WEAR_RAISED,     /**< Near the budget; only records up to the governor level are stored. */
+    OVYL_LOG_STORAGE_WEAR_THROTTLED,  /**< Hourly budget spent; flash writes are dropped until the next hour. */
+} ovyl_log_storage_wear_state_t;
+
+/** @brief Wear accounting snapshot returned by ovyl_log_storage_get_wear(). */
+typedef struct ovyl_log_storage_wear_status_t {
+    ovyl_log_storage_wear_state_t state; /**< Current governor state. */
+    uint8_t level;                       /**< Most verbose level currently stored. */
+    uint32_t minutes;                    /**< Powered-on minutes accounted so far. */
+    uint64_t bytes;                      /**< Lifetime bytes written to main-log and lane sectors. */
+    uint32_t hour_bytes;                 /**< Bytes written during the current hour. */
+    uint32_t last_hour_bytes;            /**< Bytes written during the previous full hour. */
+    uint32_t budget_per_hour;            /**< Bytes per hour that keep the log within its lifetime budget. */
+    uint32_t max_erases;                 /**< Highest erase count of a main-log or lane sector. */
+    uint32_t throttled;                  /**< Messages dropped by the governor since boot. */
+} ovyl_log_storage_wear_status_t;
+
 /**
  * @brief Initialize the flash-backed log storage subsystem.
  *
  * Opens the configured flash partition, sets up the underlying FCB instance,
  * and prepares the module mutex.
  *
+ * The FCB sectors are built at runtime from the partition's flash pages:
+ * small pages are merged into sectors of at least
+ * CONFIG_OVYL_LOG_STORAGE_MIN_SECTOR_SIZE bytes, and into larger ones when
+ * the partition has more pages than the sector table holds. Logs written with
+ * a different layout are cleared rather than read with the wrong geometry.
+ *
  * @retval 0 Success.
- * @retval -E2BIG Reported sector count exceeds internal buffer.
+ * @retval -E2BIG The partition needs more sectors than the sector table holds.
+ * @retval -EINVAL The partition does not start and end on flash page boundaries.
  * @retval Negative errno value from underlying flash/FCB helpers.
  */
 int ovyl_log_storage_init(void);
@@ -50,17 +271,88 @@ int ovyl_log_storage_init(void);
  * @param buf Pointer to the log record buffer.
  * @param buf_size Number of bytes to write; zero is treated as a no-op.
  *
- * @retval 0 Success.
+ * With CONFIG_OVYL_LOG_STORAGE_ASYNC, data that does not fit in a full ring is
+ * dropped under the configured overflow policy, counted in the async_dropped
+ * statistic, and reported as success.
+ *
+ * @retval 0 Success, or dropped because the ring was full.
  * @retval -EINVAL When @p buf is NULL.
+ * @retval -EMSGSIZE @p buf_size exceeds the whole ring (ASYNC only).
  * @retval -EBUSY Unable to obtain mutex within timeout.
  * @retval Negative errno value from flash/FCB APIs.
  */
 int ovyl_log_storage_add_data(const void *buf, size_t buf_size);
 
+/**
+ * @brief Append one log record behind a structured header.
+ *
+ * Requires CONFIG_OVYL_LOG_STORAGE_RECORD_HDR. The caller reserves
+ * OVYL_LOG_STORAGE_RECORD_HDR_SIZE bytes at the start of @p record, followed
+ * by the payload; the header is encoded in place so header and payload are
+ * stored with a single append. The boot id and sequence number are assigned
+ * here; the remaining fields come from @p hdr. With
+ * CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE, records at or above the lane level
+ * are written straight to the priority lane instead.
+ *
+ * @param hdr Timestamp, level, source id and flags of the record.
+ * @param record Header space followed by @p payload_len payload bytes.
+ * @param payload_len Payload size in bytes.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid arguments, unknown flags, or payload longer than
+ *         CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE.
+ * @retval -ENOTSUP Record headers are disabled.
+ * @retval Negative errno value from ovyl_log_storage_add_data().
+ */
+int ovyl_log_storage_add_record(const ovyl_log_storage_record_hdr_t *hdr, uint8_t *record, size_t payload_len);
+
+/**
+ * @brief Decode a record header read back from storage.
+ *
+ * @param buf OVYL_LOG_STORAGE_RECORD_HDR_SIZE bytes starting at a record.
+ * @param hdr Populated with the decoded fields.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL @p buf does not start with a record header: wrong sync
+ *         byte, unknown flags, a level above LOG_LEVEL_DBG, or a payload
+ *         longer than CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE.
+ */
+int ovyl_log_storage_record_hdr_decode(const uint8_t *buf, ovyl_log_storage_record_hdr_t *hdr);
+
+/**
+ * @brief Write any queued or staged log data to flash.
+ *
+ * Drains the async writer ring and the RAM staging buffer when enabled.
+ *
+ * @retval 0 Success.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval Negative errno value from flash/FCB APIs.
+ */
+int ovyl_log_storage_flush(void);
+
+/**
+ * @brief Switch storage to synchronous writes and flush pending data.
+ *
+ * Intended for the LOG_PANIC path: once called, appends bypass the async
+ * writer ring and any queued or staged data is written immediately.
+ *
+ * With CONFIG_OVYL_LOG_STORAGE_PANIC_REGION the mutex is never taken again:
+ * queued data and every later append go straight to the reserved panic
+ * region, which is copied into the log on the next boot.
+ *
+ * @retval 0 Success.
+ * @retval -ENOSPC The panic region is full.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval Negative errno value from flash/FCB APIs.
+ */
+int ovyl_log_storage_panic(void);
+
 /**
  * @brief Fetch the next chunk of stored log bytes.
  *
  * Callers should continue invoking this function until it returns -ENOENT.
+ * Like cursors and the uploader, this reads the main log only; the priority
+ * lane is included by ovyl_log_storage_export().
  *
  * @param dst Destination buffer to populate.
  * @param dest_size Destination buffer size in bytes.
@@ -74,15 +366,207 @@ int ovyl_log_storage_add_data(const void *buf, size_t buf_size);
  */
 int ovyl_log_storage_fetch_data(void *dst, size_t dest_size, size_t *out_size);
 
+/**
+ * @brief Fill a buffer with stored log bytes spanning as many entries as fit.
+ *
+ * Shares the read position of ovyl_log_storage_fetch_data() but copies across
+ * entry boundaries in a single locked pass. With
+ * OVYL_LOG_STORAGE_BULK_ENTRY_HDR each entry is preceded by its payload length
+ * (OVYL_LOG_STORAGE_BULK_HDR_SIZE bytes, little endian); an entry that does not
+ * fit continues at the start of the next call without a new header.
+ *
+ * @param dst Destination buffer to populate.
+ * @param dest_size Destination buffer size in bytes.
+ * @param flags Zero or OVYL_LOG_STORAGE_BULK_ENTRY_HDR.
+ * @param out_size Populated with the number of bytes written to @p dst.
+ *
+ * @retval 0 Success; @p out_size may be smaller than @p dest_size at the end of data.
+ * @retval -ENOENT No additional data is available.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EINVAL Invalid arguments.
+ * @retval -EIO Flash read failure.
+ */
+int ovyl_log_storage_fetch_bulk(void *dst, size_t dest_size, uint32_t flags, size_t *out_size);
+
 /**
  * @brief Reset the internal read cursor used during exports.
  */
 void ovyl_log_storage_reset_read(void);
 
+/**
+ * @brief Position the export read cursor at the sector holding a point in time.
+ *
+ * Requires CONFIG_OVYL_LOG_STORAGE_TIME_INDEX. Uses the per-sector time index
+ * to jump to the newest sector that started at or before @p uptime_ms of boot
+ * @p boot_id (or the oldest sector if the time predates all stored logs), so
+ * the next ovyl_log_storage_fetch_data() returns that sector's first entry.
+ * Resolution is one sector.
+ *
+ * @param boot_id Boot session, see ovyl_log_storage_boot_id().
+ * @param uptime_ms Uptime within that boot in milliseconds.
+ *
+ * @retval 0 Success.
+ * @retval -ENOENT No indexed log data.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_TIME_INDEX is disabled.
+ */
+int ovyl_log_storage_seek_time(uint16_t boot_id, uint64_t uptime_ms);
+
+/**
+ * @brief Identifier of the current boot session as recorded in the time index.
+ *
+ * @return Boot id, one higher than the newest boot found in storage at init.
+ */
+uint16_t ovyl_log_storage_boot_id(void);
+
+/**
+ * @brief Open a named read cursor from the statically allocated pool.
+ *
+ * Each cursor keeps its own position, starting at the oldest stored entry, so
+ * several consumers can stream logs concurrently. When rotation erases the
+ * sector a cursor is positioned in (or has not reached yet), the cursor moves
+ * to the oldest remaining entry and the loss is counted.
+ *
+ * @param name Consumer name; must stay valid until the cursor is closed.
+ * @param cursor Populated with the cursor handle.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid arguments.
+ * @retval -EEXIST A cursor with @p name is already open.
+ * @retval -ENOMEM All CONFIG_OVYL_LOG_STORAGE_CURSOR_COUNT cursors are in use.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ */
+int ovyl_log_storage_cursor_open(const char *name, ovyl_log_storage_cursor_t **cursor);
+
+/**
+ * @brief Fetch the next chunk of stored log bytes for a cursor.
+ *
+ * Behaves like ovyl_log_storage_fetch_data() but reads up to the live tail;
+ * after -ENOENT, later calls return entries appended in the meantime.
+ *
+ * @param cursor Cursor handle.
+ * @param dst Destination buffer to populate.
+ * @param dest_size Destination buffer size in bytes.
+ * @param out_size Populated with the number of bytes written to @p dst.
+ *
+ * @retval 0 Success.
+ * @retval -ENOENT No additional data is available.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EINVAL Invalid arguments or closed cursor.
+ * @retval -EIO Flash read failure.
+ */
+int ovyl_log_storage_cursor_fetch(ovyl_log_storage_cursor_t *cursor,
+                                  void *dst,
+                                  size_t dest_size,
+                                  size_t *out_size);
+
+/**
+ * @brief Bulk variant of ovyl_log_storage_cursor_fetch().
+ *
+ * See ovyl_log_storage_fetch_bulk() for the buffer layout and @p flags.
+ *
+ * @retval 0 Success.
+ * @retval -ENOENT No additional data is available.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EINVAL Invalid arguments or closed cursor.
+ * @retval -EIO Flash read failure.
+ */
+int ovyl_log_storage_cursor_fetch_bulk(ovyl_log_storage_cursor_t *cursor,
+                                       void *dst,
+                                       size_t dest_size,
+                                       uint32_t flags,
+                                       size_t *out_size);
+
+/**
+ * @brief Move a cursor back to the oldest stored entry and clear its loss counter.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid or closed cursor.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ */
+int ovyl_log_storage_cursor_rewind(ovyl_log_storage_cursor_t *cursor);
+
+/**
+ * @brief Number of sectors rotated out before the cursor read them.
+ *
+ * @param cursor Cursor handle.
+ * @return Lost sector count, or 0 for an invalid cursor.
+ */
+uint32_t ovyl_log_storage_cursor_lost_sectors(const ovyl_log_storage_cursor_t *cursor);
+
+/**
+ * @brief Return a cursor to the pool.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid or already closed cursor.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ */
+int ovyl_log_storage_cursor_close(ovyl_log_storage_cursor_t *cursor);
+
+/**
+ * @brief Fetch the next chunk of log bytes not yet acknowledged by the uploader.
+ *
+ * Requires CONFIG_OVYL_LOG_STORAGE_WATERMARK. Reading starts after the
+ * persisted upload watermark (or at the oldest entry when none is stored or
+ * its sector has been rotated out) and continues up to the live tail.
+ *
+ * @param dst Destination buffer to populate.
+ * @param dest_size Destination buffer size in bytes.
+ * @param out_size Populated with the number of bytes written to @p dst.
+ *
+ * @retval 0 Success.
+ * @retval -ENOENT Everything stored has been fetched.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EINVAL Invalid arguments.
+ * @retval -EIO Flash read failure.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_WATERMARK is disabled.
+ */
+int ovyl_log_storage_upload_fetch(void *dst, size_t dest_size, size_t *out_size);
+
+/**
+ * @brief Acknowledge every entry fully returned by ovyl_log_storage_upload_fetch().
+ *
+ * Moves the upload watermark past those entries and persists it through the
+ * Ovyl Config module so the next upload, even after a reboot, starts after them.
+ *
+ * @retval 0 Success (also when there was nothing new to acknowledge).
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EIO Failed to persist the watermark.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_WATERMARK is disabled.
+ */
+int ovyl_log_storage_upload_ack(void);
+
+/**
+ * @brief Restart the upload from the last acknowledged watermark.
+ *
+ * Call after a failed transfer so unacknowledged entries are sent again.
+ *
+ * @retval 0 Success.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_WATERMARK is disabled.
+ */
+int ovyl_log_storage_upload_rewind(void);
+
+/**
+ * @brief Forget the upload watermark so the next upload starts at the oldest entry.
+ *
+ * @retval 0 Success.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -EIO Failed to persist the watermark.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_WATERMARK is disabled.
+ */
+int ovyl_log_storage_upload_reset(void);
+
 /**
  * @brief Clear all stored log entries from flash.
  *
+ * With CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR the entries are only hidden: the
+ * call records the current write position and returns without erasing, and
+ * the hidden sectors are erased by normal rotation when their space is needed.
+ *
  * @retval 0 Success.
+ * @retval -EIO The clear position could not be persisted; the entries stay
+ *              hidden until the next reboot only.
  * @retval Negative errno value from FCB operations.
  */
 int ovyl_log_storage_clear(void);
@@ -90,13 +574,96 @@ int ovyl_log_storage_clear(void);
 /**
  * @brief Mark whether a log export is currently in progress.
  *
- * When @p in_progress is true the module pauses automatic writes to avoid
- * race conditions with active exports.
+ * Setting @p in_progress to true captures a snapshot of the current write
+ * position: ovyl_log_storage_fetch_data() stops at that point and sector
+ * rotation will not erase entries the export has not read yet. Logging
+ * continues during the export; writes that would require erasing unread
+ * data are dropped and counted in ovyl_log_storage_stats_t::export_dropped.
  *
  * @param in_progress Flag indicating export state.
  */
 void ovyl_log_storage_set_export_in_progress(bool in_progress);
 
+/**
+ * @brief Stream a snapshot of the stored logs into a sink.
+ *
+ * Reads the entries present when the call starts in chunks of up to
+ * CONFIG_OVYL_LOG_STORAGE_EXPORT_CHUNK_SIZE bytes, spanning entry boundaries,
+ * and hands each chunk to the sink straight from the export buffer. The
+ * storage lock is only held while a chunk is read, so logging continues. When
+ * the sink reports no credit the export waits, and gives up with -ETIMEDOUT
+ * if the sink stays stalled for several seconds.
+ *
+ * Level and source filters match each log record (a text line, or a
+ * dictionary record) before it reaches the sink; lines without a record
+ * header, such as hexdump rows, follow the record they belong to. The boot
+ * filter matches whole entries and needs CONFIG_OVYL_LOG_STORAGE_TIME_INDEX.
+ *
+ * With CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE the records of the priority lane
+ * are merged into the main log in (boot, sequence) order.
+ *
+ * @param sink Export destination.
+ * @param filter Optional selection and framing options, or NULL for everything.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid sink or filter. Record filters and the priority
+ *                 lane cannot be combined with OVYL_LOG_STORAGE_BULK_ENTRY_HDR.
+ * @retval -EBUSY Another export is running or the mutex was unavailable.
+ * @retval -ENOTSUP Time or boot filters requested without CONFIG_OVYL_LOG_STORAGE_TIME_INDEX,
+ *                  or any filter with the LittleFS backend.
+ * @retval -ETIMEDOUT The sink did not grant credit in time.
+ * @retval Negative errno returned by the sink or a flash read failure.
+ */
+int ovyl_log_storage_export(const ovyl_log_storage_sink_t *sink, const ovyl_log_storage_filter_t *filter);
+
+/**
+ * @brief Copy the current log storage counters.
+ *
+ * @param stats Destination for the counters.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL When @p stats is NULL.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ */
+int ovyl_log_storage_get_stats(ovyl_log_storage_stats_t *stats);
+
+/**
+ * @brief Reset all log storage counters to zero.
+ */
+void ovyl_log_storage_reset_stats(void);
+
+/**
+ * @brief Enable or disable background pre-erase of the next FCB sector.
+ *
+ * @param enable True to erase sectors ahead of the writer, false to rotate inline.
+ *
+ * @retval 0 Success.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD is disabled.
+ */
+int ovyl_log_storage_set_erase_ahead(bool enable);
+
+/**
+ * @brief Report flash wear and the state of the write-budget governor.
+ *
+ * @param status Destination for the snapshot.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL When @p status is NULL.
+ * @retval -EBUSY Unable to obtain mutex within timeout.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_WEAR is disabled.
+ */
+int ovyl_log_storage_get_wear(ovyl_log_storage_wear_status_t *status);
+
+/**
+ * @brief Most verbose log level the write-budget governor lets into flash.
+ *
+ * The flash backend drops messages above this level before formatting them.
+ * Returns LOG_LEVEL_NONE while the governor is throttling, so every message is
+ * dropped. Returns LOG_LEVEL_DBG while the governor is not raised, and always
+ * when CONFIG_OVYL_LOG_STORAGE_WEAR is disabled.
+ */
+uint8_t ovyl_log_storage_wear_level(void);
+
 /**
  * @brief Initialize runtime log levels from persisted configuration.
  *
@@ -108,6 +675,8 @@ void ovyl_log_storage_init_log_level(void);
 /**
  * @brief Update the runtime log level for all modules and persist it.
  *
+ * Modules with a per-module override keep their own level.
+ *
  * @param level Requested Zephyr log severity (1-4).
  *
  * @retval 0 Success.
@@ -116,6 +685,70 @@ void ovyl_log_storage_init_log_level(void);
  */
 int ovyl_log_storage_set_log_level(uint8_t level);
 
+/**
+ * @brief Set and persist the most verbose level the flash backend stores.
+ *
+ * Uses the flash backend's own runtime filter, so console backends keep the
+ * global and per-module levels while flash stores each module at the lower
+ * of its level and this one.
+ *
+ * @param level Zephyr log severity (1-4), clamped to the minimum runtime level.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Requested level is invalid.
+ * @retval -EIO Unable to persist the level.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL is disabled.
+ */
+int ovyl_log_storage_set_flash_level(uint8_t level);
+
+/**
+ * @brief Most verbose level the flash backend stores; LOG_LEVEL_DBG when not limited.
+ */
+uint8_t ovyl_log_storage_get_flash_level(void);
+
+/**
+ * @brief Override and persist the runtime log level of one module.
+ *
+ * The override is applied again by ovyl_log_storage_init_log_level() on every
+ * boot and survives ovyl_log_storage_set_log_level().
+ *
+ * @param module Log module name as registered with LOG_MODULE_REGISTER().
+ * @param level Requested Zephyr log severity (1-4), clamped to the minimum runtime level.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Requested level is invalid.
+ * @retval -ENOENT No log module has that name.
+ * @retval -ENOMEM CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS_MAX overrides are in use.
+ * @retval -EIO Unable to persist the override.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS is disabled.
+ */
+int ovyl_log_storage_set_module_level(const char *module, uint8_t level);
+
+/**
+ * @brief Report the runtime log level of one module.
+ *
+ * @param module Log module name.
+ * @param level Populated with the module's runtime level.
+ * @param overridden Populated with whether a per-module override is persisted; may be NULL.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL @p module or @p level is NULL.
+ * @retval -ENOENT No log module has that name.
+ */
+int ovyl_log_storage_get_module_level(const char *module, uint8_t *level, bool *overridden);
+
+/**
+ * @brief Drop the override of one module and return it to the global level.
+ *
+ * @param module Log module name.
+ *
+ * @retval 0 Success, also when the module had no override.
+ * @retval -ENOENT No log module has that name.
+ * @retval -EIO Unable to persist the change.
+ * @retval -ENOTSUP CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS is disabled.
+ */
+int ovyl_log_storage_reset_module_level(const char *module);
+
 #ifdef __cplusplus
 }
 #endif
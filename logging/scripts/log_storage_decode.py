@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Ovyl
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Decode logs stored with CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY or
+CONFIG_OVYL_LOG_STORAGE_RECORD_HDR.
+
+Accepts either the hex lines printed by `log_storage export` (captured from a
+terminal) or a raw binary dump produced with ovyl_log_storage_fetch_data(), and
+renders them as text using the build's dictionary database and Zephyr's
+dictionary log parser.
+
+With --records the input is split into structured records, which are ordered
+by boot id and sequence number before decoding. Text payloads need no
+dictionary database.
+
+Example:
+    log_storage_decode.py build/zephyr/log_dictionary.json export.txt
+    log_storage_decode.py --binary build/zephyr/log_dictionary.json dump.bin
+    log_storage_decode.py --records export.txt
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+HEX_LINE_RE = re.compile(r"^[0-9a-fA-F]+$")
+
+# Mirrors OVYL_LOG_STORAGE_RECORD_* in include/ovyl/log_storage.h.
+RECORD_HDR = struct.Struct("<BBHHHIQ")
+RECORD_SYNC = 0xA5
+RECORD_CONT = 0x01
+LEVEL_NAMES = {0: "---", 1: "err", 2: "wrn", 3: "inf", 4: "dbg"}
+
+
+def load_zephyr_parser(zephyr_base):
+    """Make Zephyr's dictionary_parser package importable."""
+    parser_dir = os.path.join(zephyr_base, "scripts", "logging", "dictionary")
+    if not os.path.isdir(parser_dir):
+        sys.exit(f"❌ Zephyr dictionary parser not found in {parser_dir}")
+
+    sys.path.insert(0, parser_dir)
+
+    import dictionary_parser  # pylint: disable=import-outside-toplevel
+    from dictionary_parser.log_database import LogDatabase  # pylint: disable=import-outside-toplevel
+
+    return dictionary_parser, LogDatabase
+
+
+def read_hex_export(path):
+    """Collect the hex lines of a shell export, ignoring prompts and other output."""
+    data = bytearray()
+
+    with open(path, "r", encoding="utf-8", errors="ignore") as f:
+        for line in f:
+            line = line.strip()
+            if len(line) % 2 == 0 and HEX_LINE_RE.match(line):
+                data.extend(bytes.fromhex(line))
+
+    return bytes(data)
+
+
+def read_binary_dump(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def split_records(data):
+    """Split a record stream into (boot, seq, level, source, flags, timestamp, payload) tuples."""
+    records = []
+    offset = 0
+
+    while offset + RECORD_HDR.size <= len(data):
+        sync, level_flags, source, boot, length, seq, timestamp = RECORD_HDR.unpack_from(data, offset)
+        if sync != RECORD_SYNC or (level_flags & 0x07) > 4 or (level_flags >> 3) & ~RECORD_CONT:
+            # Skip bytes until the next header, e.g. after a truncated record.
+            offset += 1
+            continue
+
+        start = offset + RECORD_HDR.size
+        payload = data[start:start + length]
+        records.append((boot, seq, level_flags & 0x07, source, level_flags >> 3, timestamp, payload))
+        offset = start + length
+
+    # Stable sort keeps continuations after the record they extend.
+    records.sort(key=lambda r: (r[0], r[1]))
+    return records
+
+
+def print_text_records(records):
+    for boot, seq, level, source, flags, timestamp, payload in records:
+        text = payload.decode("utf-8", errors="replace")
+        if flags & RECORD_CONT:
+            sys.stdout.write(text)
+        else:
+            src = "-" if source == 0xFFFF else str(source)
+            sys.stdout.write(f"{boot}:{seq} ts={timestamp} <{LEVEL_NAMES.get(level, '?')}> src={src} {text}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Ovyl dictionary-format log storage exports")
+    parser.add_argument("dbfile",
+                        nargs="?",
+                        help="Dictionary database (build/zephyr/log_dictionary.json); "
+                             "omit for text records")
+    parser.add_argument("logfile", help="Captured 'log_storage export' output or raw dump")
+    parser.add_argument("--binary", action="store_true", help="Input is a raw binary dump")
+    parser.add_argument("--records",
+                        action="store_true",
+                        help="Input carries CONFIG_OVYL_LOG_STORAGE_RECORD_HDR headers")
+    parser.add_argument("--zephyr-base",
+                        default=os.environ.get("ZEPHYR_BASE"),
+                        help="Zephyr tree (defaults to $ZEPHYR_BASE)")
+    parser.add_argument("--debug", action="store_true", help="Print parser debug output")
+    args = parser.parse_args()
+
+    logdata = read_binary_dump(args.logfile) if args.binary else read_hex_export(args.logfile)
+    if not logdata:
+        sys.exit("❌ No log data found in input")
+
+    if args.records:
+        records = split_records(logdata)
+        if args.dbfile is None:
+            print_text_records(records)
+            return
+        logdata = b"".join(r[6] for r in records)
+
+    if args.dbfile is None:
+        sys.exit("❌ A dictionary database is required unless --records is used with text payloads")
+
+    if not args.zephyr_base:
+        sys.exit("❌ Set ZEPHYR_BASE or pass --zephyr-base")
+
+    dictionary_parser, LogDatabase = load_zephyr_parser(args.zephyr_base)
+
+    database = LogDatabase.read_json_database(args.dbfile)
+    if database is None:
+        sys.exit(f"❌ Unable to read dictionary database {args.dbfile}")
+
+    log_parser = dictionary_parser.get_parser(database)
+    if log_parser is None:
+        sys.exit("❌ Unsupported dictionary database version")
+
+    log_parser.parse_log_data(logdata, debug=args.debug)
+
+
+if __name__ == "__main__":
+    main()
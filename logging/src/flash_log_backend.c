@@ -17,42 +17,368 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/logging/log_backend.h>
 #include <zephyr/logging/log_output.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+#include <zephyr/logging/log_output_dict.h>
+#endif
 #include <zephyr/logging/log_ctrl.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+#include <zephyr/logging/log_internal.h>
+#endif
 #include <zephyr/sys/util.h>
+#if defined(CONFIG_OVYL_LOG_STORAGE_DEDUP) || defined(CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT)
+#include <zephyr/kernel.h>
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+#include <zephyr/sys/printk.h>
+#endif
 
 #define FLASH_LOG_BUFFER_SIZE CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE
 
+#ifdef CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT
+/* Bucket levels are kept in thousandths of a token so refill stays exact per millisecond. */
+#define FLASH_LOG_TOKEN (1000U)
+#define FLASH_LOG_BUCKET_CAPACITY (CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT_BURST * FLASH_LOG_TOKEN)
+#endif
+
 static uint8_t flash_log_buf[FLASH_LOG_BUFFER_SIZE];
 
+/* Set when storing part of the current message failed; such messages are reported as dropped. */
+static bool flash_log_write_failed;
+static uint32_t flash_log_write_dropped;
+
 BUILD_ASSERT(FLASH_LOG_BUFFER_SIZE > 0, "Flash log buffer must be positive");
 
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+/** @brief Last stored message and the number of identical copies suppressed since. */
+typedef struct {
+    uint32_t hash;
+    uint32_t start_ms;
+    uint32_t repeats;
+    int16_t source_id;
+    uint8_t level;
+    bool valid;
+} flash_log_dedup_t;
+
+static flash_log_dedup_t flash_log_dedup;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT
+/** @brief Token bucket of one log source; sources hashing to the same slot take it over. */
+typedef struct {
+    int16_t source_id;
+    bool in_use;
+    uint32_t tokens;
+    uint32_t last_ms;
+} flash_log_bucket_t;
+
+static flash_log_bucket_t flash_log_buckets[CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT_SLOTS];
+static uint32_t flash_log_rate_dropped;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+BUILD_ASSERT(FLASH_LOG_BUFFER_SIZE <= UINT16_MAX, "Record payload length is 16 bits");
+
+/* Header space followed by the formatted payload of the current message. */
+static uint8_t flash_log_record[OVYL_LOG_STORAGE_RECORD_HDR_SIZE + FLASH_LOG_BUFFER_SIZE];
+static size_t flash_log_record_len;
+static ovyl_log_storage_record_hdr_t flash_log_record_hdr;
+
+/** @brief Start the record for a message; @p source_id is negative when not tied to a module. */
+static void prv_flash_log_record_begin(uint8_t level, int16_t source_id, log_timestamp_t timestamp)
+{
+    flash_log_record_hdr.timestamp = timestamp;
+    flash_log_record_hdr.level = level;
+    flash_log_record_hdr.source_id = (source_id < 0) ? OVYL_LOG_STORAGE_RECORD_NO_SOURCE : (uint16_t)source_id;
+    flash_log_record_hdr.flags = 0U;
+    flash_log_record_len = 0U;
+}
+
+/**
+ * @brief Store the assembled record; further output of the same message continues it.
+ *
+ * A record that cannot be stored marks the message as dropped.
+ */
+static void prv_flash_log_record_emit(void)
+{
+    if (ovyl_log_storage_add_record(&flash_log_record_hdr, flash_log_record, flash_log_record_len) < 0) {
+        flash_log_write_failed = true;
+    }
+
+    flash_log_record_len = 0U;
+    flash_log_record_hdr.flags |= OVYL_LOG_STORAGE_RECORD_CONT;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_RECORD_HDR */
+
 /** @brief Zephyr log_output callback that persists formatted logs. */
 static int prv_flash_log_output_func(uint8_t *data, size_t length, void *ctx)
 {
     ARG_UNUSED(ctx);
 
-    int ret = ovyl_log_storage_add_data(data, length);
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    /* Gather the message into one record; log_output retries what is not consumed. */
+    size_t len = MIN(length, FLASH_LOG_BUFFER_SIZE - flash_log_record_len);
+
+    memcpy(&flash_log_record[OVYL_LOG_STORAGE_RECORD_HDR_SIZE + flash_log_record_len], data, len);
+    flash_log_record_len += len;
 
-    if (ret < 0) {
-        return ret;
+    if (flash_log_record_len == FLASH_LOG_BUFFER_SIZE) {
+        prv_flash_log_record_emit();
+    }
+
+    return (int)len;
+#else
+    /* log_output retries anything not consumed, so a failed write is dropped rather than returned. */
+    if (ovyl_log_storage_add_data(data, length) < 0) {
+        flash_log_write_failed = true;
     }
 
     return (int)length;
+#endif
 }
 
 LOG_OUTPUT_DEFINE(flash_log_output, prv_flash_log_output_func, flash_log_buf, sizeof(flash_log_buf));
 
+/** @brief Store a "messages dropped" notice for @p cnt messages. */
+static void prv_flash_log_dropped(uint32_t cnt)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    prv_flash_log_record_begin(LOG_LEVEL_NONE, -1, z_log_timestamp());
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+    log_dict_output_dropped_process(&flash_log_output, cnt);
+#else
+    log_output_dropped_process(&flash_log_output, cnt);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    if (flash_log_record_len > 0U) {
+        prv_flash_log_record_emit();
+    }
+#endif
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+/** @brief Fold @p len bytes into a 32-bit FNV-1a hash. */
+static uint32_t prv_flash_log_hash(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *bytes = data;
+
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/** @brief Hash what makes two messages identical: source, level, format package and hexdump data. */
+static uint32_t prv_flash_log_msg_hash(struct log_msg *msg)
+{
+    int16_t source_id = log_msg_get_source_id(msg);
+    uint8_t level = log_msg_get_level(msg);
+    size_t len = 0U;
+    uint32_t hash = 2166136261U;
+
+    hash = prv_flash_log_hash(hash, &source_id, sizeof(source_id));
+    hash = prv_flash_log_hash(hash, &level, sizeof(level));
+
+    uint8_t *package = log_msg_get_package(msg, &len);
+
+    hash = prv_flash_log_hash(hash, package, len);
+
+    uint8_t *data = log_msg_get_data(msg, &len);
+
+    return prv_flash_log_hash(hash, data, len);
+}
+
+/** @brief Store the "repeated N times" summary for the last message, if copies were suppressed. */
+static void prv_flash_log_dedup_flush(void)
+{
+    uint32_t repeats = flash_log_dedup.repeats;
+
+    if (repeats == 0U) {
+        return;
+    }
+
+    flash_log_dedup.repeats = 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+    /* Dictionary streams have no free-form text; report the copies as dropped. */
+    prv_flash_log_dropped(repeats);
+#else
+    char line[48];
+    int len = snprintk(line, sizeof(line), "--- last message repeated %u times ---\n", repeats);
+    size_t off = 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    prv_flash_log_record_begin(flash_log_dedup.level, flash_log_dedup.source_id, z_log_timestamp());
+#endif
+
+    while (off < (size_t)len) {
+        int ret = prv_flash_log_output_func((uint8_t *)&line[off], (size_t)len - off, NULL);
+
+        if (ret <= 0) {
+            break;
+        }
+
+        off += (size_t)ret;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    if (flash_log_record_len > 0U) {
+        prv_flash_log_record_emit();
+    }
+#endif
+#endif /* CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY */
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_DEDUP */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT
+/** @brief Take one token from the bucket of @p source_id; messages without a source are not limited. */
+static bool prv_flash_log_take_token(int16_t source_id)
+{
+    if (source_id < 0) {
+        return true;
+    }
+
+    flash_log_bucket_t *bucket = &flash_log_buckets[source_id % CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT_SLOTS];
+    uint32_t now = k_uptime_get_32();
+
+    if (!bucket->in_use || (bucket->source_id != source_id)) {
+        bucket->source_id = source_id;
+        bucket->in_use = true;
+        bucket->tokens = FLASH_LOG_BUCKET_CAPACITY;
+    } else {
+        uint64_t refill = (uint64_t)(now - bucket->last_ms) * CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT_PER_SEC;
+
+        bucket->tokens = (uint32_t)MIN((uint64_t)bucket->tokens + refill, (uint64_t)FLASH_LOG_BUCKET_CAPACITY);
+    }
+
+    bucket->last_ms = now;
+
+    if (bucket->tokens < FLASH_LOG_TOKEN) {
+        return false;
+    }
+
+    bucket->tokens -= FLASH_LOG_TOKEN;
+    return true;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT */
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_DEDUP) || defined(CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT)
+/**
+ * @brief Decide whether a message reaches flash.
+ *
+ * Copies of the last stored message within CONFIG_OVYL_LOG_STORAGE_DEDUP_WINDOW_MS
+ * are only counted; the count is stored as a summary before the next message
+ * that is kept. Messages over their source's rate are counted as dropped.
+ */
+static bool prv_flash_log_admit(struct log_msg *msg)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+    uint32_t now = k_uptime_get_32();
+    uint32_t hash = prv_flash_log_msg_hash(msg);
+
+    if (flash_log_dedup.valid && (flash_log_dedup.hash == hash) &&
+        ((now - flash_log_dedup.start_ms) < CONFIG_OVYL_LOG_STORAGE_DEDUP_WINDOW_MS)) {
+        flash_log_dedup.repeats++;
+        return false;
+    }
+
+    prv_flash_log_dedup_flush();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT
+    if (!prv_flash_log_take_token(log_msg_get_source_id(msg))) {
+        flash_log_rate_dropped++;
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+        /* Copies of a message that was never stored must not collapse into it. */
+        flash_log_dedup.valid = false;
+#endif
+        return false;
+    }
+
+    if (flash_log_rate_dropped > 0U) {
+        prv_flash_log_dropped(flash_log_rate_dropped);
+        flash_log_rate_dropped = 0U;
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+    flash_log_dedup.hash = hash;
+    flash_log_dedup.start_ms = now;
+    flash_log_dedup.source_id = log_msg_get_source_id(msg);
+    flash_log_dedup.level = log_msg_get_level(msg);
+    flash_log_dedup.valid = true;
+#endif
+
+    return true;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_DEDUP || CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT */
+
 /** @brief Process a log message and route it into flash storage. */
 static void prv_flash_log_backend_process(const struct log_backend *const backend, union log_msg_generic *msg)
 {
     ARG_UNUSED(backend);
 
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    uint8_t level = log_msg_get_level(&msg->log);
+    uint8_t wear_level = ovyl_log_storage_wear_level();
+
+    /* The write-budget governor raised the stored level or is throttling; skip formatting what would be dropped. */
+    if (wear_level == LOG_LEVEL_NONE) {
+        /* Noted as dropped once the budget allows writes again. */
+        flash_log_write_dropped++;
+        return;
+    }
+
+    if ((level != LOG_LEVEL_NONE) && (level > wear_level)) {
+        return;
+    }
+#endif
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_DEDUP) || defined(CONFIG_OVYL_LOG_STORAGE_RATE_LIMIT)
+    if (!prv_flash_log_admit(&msg->log)) {
+        return;
+    }
+#endif
+
+    if (flash_log_write_dropped > 0U) {
+        uint32_t cnt = flash_log_write_dropped;
+
+        flash_log_write_dropped = 0U;
+        prv_flash_log_dropped(cnt);
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    prv_flash_log_record_begin(log_msg_get_level(&msg->log),
+                               log_msg_get_source_id(&msg->log),
+                               log_msg_get_timestamp(&msg->log));
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+    /* Persist the raw cbprintf package, source, level and timestamp; decoded on the host. */
+    log_dict_output_msg_process(&flash_log_output, &msg->log, 0);
+#else
     uint32_t flags = LOG_OUTPUT_FLAG_LEVEL |
                      LOG_OUTPUT_FLAG_TIMESTAMP |
                      LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP |
                      LOG_OUTPUT_FLAG_CRLF_LFONLY;
 
     log_output_msg_process(&flash_log_output, &msg->log, flags);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    if (flash_log_record_len > 0U) {
+        prv_flash_log_record_emit();
+    }
+#endif
+
+    if (flash_log_write_failed) {
+        flash_log_write_failed = false;
+        flash_log_write_dropped++;
+    }
 }
 
 /** @brief Initialize backend by priming log storage. */
@@ -68,7 +394,19 @@ static void prv_flash_log_backend_panic(const struct log_backend *const backend)
 {
     ARG_UNUSED(backend);
 
+    (void)ovyl_log_storage_panic();
     log_output_flush(&flash_log_output);
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    if (flash_log_record_len > 0U) {
+        prv_flash_log_record_emit();
+    }
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_DEDUP
+    /* Keep the repeat count of the burst that led up to the panic. */
+    prv_flash_log_dedup_flush();
+    flash_log_dedup.valid = false;
+#endif
+    (void)ovyl_log_storage_flush();
 }
 
 /** @brief Report dropped messages to the shared log output handler. */
@@ -76,7 +414,7 @@ static void prv_flash_log_backend_dropped(const struct log_backend *const backen
 {
     ARG_UNUSED(backend);
 
-    log_output_dropped_process(&flash_log_output, cnt);
+    prv_flash_log_dropped(cnt);
 }
 
 static const struct log_backend_api flash_log_backend_api = {
@@ -87,3 +425,8 @@ static const struct log_backend_api flash_log_backend_api = {
 };
 
 LOG_BACKEND_DEFINE(flash_log_backend, flash_log_backend_api, true);
+
+const struct log_backend *ovyl_flash_log_backend_get(void)
+{
+    return &flash_log_backend;
+}
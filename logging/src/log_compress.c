@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_compress.c
+ * @brief Small-window LZSS codec used to compress log storage entries.
+ *
+ * Stream layout: a flag byte precedes every group of up to eight items. A clear
+ * bit marks a literal byte, a set bit marks a two-byte match holding a 12-bit
+ * distance (minus one) and a 4-bit length (minus three).
+ */
+
+#include "log_compress.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+
+#define LOG_COMPRESS_WINDOW CONFIG_OVYL_LOG_STORAGE_COMPRESS_WINDOW
+#define LOG_COMPRESS_MIN_MATCH (3U)
+#define LOG_COMPRESS_MAX_MATCH (LOG_COMPRESS_MIN_MATCH + 15U)
+#define LOG_COMPRESS_HASH_BITS (8U)
+#define LOG_COMPRESS_HASH_SIZE OVYL_LOG_COMPRESS_HASH_SIZE
+#define LOG_COMPRESS_NO_POS (0xFFFFU)
+
+BUILD_ASSERT(LOG_COMPRESS_WINDOW <= 4096, "Match distance is encoded in 12 bits");
+BUILD_ASSERT(LOG_COMPRESS_HASH_SIZE == BIT(LOG_COMPRESS_HASH_BITS), "Hash table size must match the hash width");
+
+/** @brief Hash the three bytes starting at @p p into the match table. */
+static uint32_t prv_hash(const uint8_t *p)
+{
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+
+    return ((v * 2654435761U) >> (32U - LOG_COMPRESS_HASH_BITS)) & (LOG_COMPRESS_HASH_SIZE - 1U);
+}
+
+size_t ovyl_log_compress_encode(ovyl_log_compress_ctx_t *ctx,
+                                const uint8_t *src,
+                                size_t src_len,
+                                uint8_t *dst,
+                                size_t dst_cap)
+{
+    size_t in = 0U;
+    size_t out = 0U;
+    size_t flag_pos = 0U;
+    uint32_t bit = 8U;
+
+    if ((ctx == NULL) || (src == NULL) || (dst == NULL) || (src_len > LOG_COMPRESS_NO_POS)) {
+        return 0U;
+    }
+
+    uint16_t *head = ctx->head;
+
+    memset(ctx->head, 0xFF, sizeof(ctx->head));
+
+    while (in < src_len) {
+        if (bit == 8U) {
+            if (out >= dst_cap) {
+                return 0U;
+            }
+            flag_pos = out++;
+            dst[flag_pos] = 0U;
+            bit = 0U;
+        }
+
+        size_t match_len = 0U;
+        size_t match_dist = 0U;
+
+        if ((in + LOG_COMPRESS_MIN_MATCH) <= src_len) {
+            uint32_t h = prv_hash(&src[in]);
+            uint16_t cand = head[h];
+
+            head[h] = (uint16_t)in;
+
+            if ((cand != LOG_COMPRESS_NO_POS) && ((in - cand) <= LOG_COMPRESS_WINDOW)) {
+                size_t max_len = MIN(src_len - in, (size_t)LOG_COMPRESS_MAX_MATCH);
+
+                while ((match_len < max_len) && (src[cand + match_len] == src[in + match_len])) {
+                    match_len++;
+                }
+                match_dist = in - cand;
+            }
+        }
+
+        if (match_len >= LOG_COMPRESS_MIN_MATCH) {
+            if ((out + 2U) > dst_cap) {
+                return 0U;
+            }
+
+            size_t dist = match_dist - 1U;
+
+            dst[out++] = (uint8_t)(dist & 0xFFU);
+            dst[out++] = (uint8_t)(((dist >> 8) << 4) | (match_len - LOG_COMPRESS_MIN_MATCH));
+            dst[flag_pos] |= (uint8_t)BIT(bit);
+
+            for (size_t k = 1U; k < match_len; k++) {
+                if ((in + k + LOG_COMPRESS_MIN_MATCH) <= src_len) {
+                    head[prv_hash(&src[in + k])] = (uint16_t)(in + k);
+                }
+            }
+            in += match_len;
+        } else {
+            if (out >= dst_cap) {
+                return 0U;
+            }
+            dst[out++] = src[in++];
+        }
+
+        bit++;
+    }
+
+    return out;
+}
+
+int ovyl_log_compress_decode(const uint8_t *src,
+                             size_t src_len,
+                             uint8_t *dst,
+                             size_t dst_cap,
+                             size_t *out_len)
+{
+    size_t in = 0U;
+    size_t out = 0U;
+
+    if ((src == NULL) || (dst == NULL) || (out_len == NULL)) {
+        return -EINVAL;
+    }
+
+    while (in < src_len) {
+        uint8_t flags = src[in++];
+
+        for (uint32_t bit = 0U; (bit < 8U) && (in < src_len); bit++) {
+            if ((flags & BIT(bit)) == 0U) {
+                if (out >= dst_cap) {
+                    return -EINVAL;
+                }
+                dst[out++] = src[in++];
+                continue;
+            }
+
+            if ((in + 2U) > src_len) {
+                return -EINVAL;
+            }
+
+            size_t dist = ((size_t)src[in] | ((size_t)(src[in + 1U] >> 4) << 8)) + 1U;
+            size_t len = (size_t)(src[in + 1U] & 0x0FU) + LOG_COMPRESS_MIN_MATCH;
+
+            in += 2U;
+
+            if ((dist > out) || ((out + len) > dst_cap)) {
+                return -EINVAL;
+            }
+
+            /* Byte-wise copy so overlapping matches replicate runs. */
+            for (size_t k = 0U; k < len; k++) {
+                dst[out] = dst[out - dist];
+                out++;
+            }
+        }
+    }
+
+    *out_len = out;
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_compress.h
+ * @brief Small-window LZSS codec used to compress log storage entries.
+ */
+
+#ifndef OVYL_LOG_COMPRESS_H
+#define OVYL_LOG_COMPRESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Worst-case encoded size for @p len input bytes (one flag byte per 8 literals). */
+#define OVYL_LOG_COMPRESS_BOUND(len) ((len) + ((len) + 7U) / 8U)
+
+/** @brief Number of match-table entries the encoder hashes into. */
+#define OVYL_LOG_COMPRESS_HASH_SIZE (256U)
+
+/** @brief Encoder workspace, kept by the caller so the match table stays off the stack. */
+typedef struct {
+    uint16_t head[OVYL_LOG_COMPRESS_HASH_SIZE]; /**< Last input position seen for each hash. */
+} ovyl_log_compress_ctx_t;
+
+/**
+ * @brief Compress a buffer.
+ *
+ * Back-references are limited to CONFIG_OVYL_LOG_STORAGE_COMPRESS_WINDOW bytes
+ * and matches are found through the hash table in @p ctx.
+ *
+ * @param ctx Encoder workspace; must not be shared by concurrent calls.
+ * @param src Input bytes.
+ * @param src_len Number of input bytes.
+ * @param dst Output buffer.
+ * @param dst_cap Output buffer size in bytes.
+ *
+ * @return Encoded length, or 0 when the result would not fit in @p dst_cap.
+ */
+size_t ovyl_log_compress_encode(ovyl_log_compress_ctx_t *ctx,
+                                const uint8_t *src,
+                                size_t src_len,
+                                uint8_t *dst,
+                                size_t dst_cap);
+
+/**
+ * @brief Decompress a buffer produced by ovyl_log_compress_encode().
+ *
+ * @param src Encoded bytes.
+ * @param src_len Number of encoded bytes.
+ * @param dst Output buffer.
+ * @param dst_cap Output buffer size in bytes.
+ * @param out_len Populated with the decoded length.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Corrupt input or output larger than @p dst_cap.
+ */
+int ovyl_log_compress_decode(const uint8_t *src,
+                             size_t src_len,
+                             uint8_t *dst,
+                             size_t dst_cap,
+                             size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVYL_LOG_COMPRESS_H */
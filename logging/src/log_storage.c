@@ -6,7 +6,12 @@
 
 /**
  * @file log_storage.c
- * @brief Flash-backed log storage implementation.
+ * @brief Log storage API on top of the selected storage backend.
+ *
+ * Owns everything that does not depend on how logs sit in flash: argument
+ * checks, the mutex, the read head, named cursors, the export loop with its
+ * record filter and sink flow control, statistics and the shell. Storage
+ * itself goes through the backend interface in log_storage_backend.h.
  */
 
 #include <ovyl/log_storage.h>
@@ -16,165 +21,105 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdlib.h>
 
-#include <zephyr/storage/flash_map.h>
-#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/logging/log_ctrl.h>
 #include <zephyr/logging/log_internal.h>
 #include <zephyr/shell/shell.h>
 #include <zephyr/sys/util.h>
-#include <zephyr/fs/fcb.h>
-
 
-#include <ovyl/config_mgr.h>
-#include <ovyl/configs.h>
+#include "log_storage_backend.h"
+#include "log_storage_export.h"
+#include "log_storage_level.h"
 
 LOG_MODULE_REGISTER(ovyl_log_storage, CONFIG_OVYL_LOG_STORAGE_LOG_LEVEL);
 
-#define LOG_STORAGE_FLASH_LABEL logging_storage
-#define LOG_STORAGE_FLASH_AREA_ID FLASH_AREA_ID(LOG_STORAGE_FLASH_LABEL)
-#define LOG_STORAGE_FCB_MAGIC (0x1EE71065U)
-#define LOG_STORAGE_SECTOR_SIZE_BYTES (4096U)
-#define LOG_STORAGE_NUM_SECTORS (FIXED_PARTITION_SIZE(LOG_STORAGE_FLASH_LABEL) / LOG_STORAGE_SECTOR_SIZE_BYTES)
 #define LOG_STORAGE_MUTEX_TIMEOUT_MS (200U)
 
-#define LOG_RUNTIME_MIN_LEVEL CONFIG_OVYL_LOG_STORAGE_MIN_RUNTIME_LEVEL
+#if defined(CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB)
+#define LOG_STORAGE_BACKEND (&ovyl_log_storage_backend_fcb)
+#elif defined(CONFIG_OVYL_LOG_STORAGE_BACKEND_LITTLEFS)
+#define LOG_STORAGE_BACKEND (&ovyl_log_storage_backend_littlefs)
+#endif
 
-/** @brief Read cursor state for exported log data. */
-typedef struct {
-    struct fcb_entry head;
-    size_t read_bytes;
-} ovyl_log_storage_read_ctx_t;
+struct ovyl_log_storage_cursor {
+    const char *name;
+    ovyl_log_storage_read_ctx_t ctx;
+    uint32_t lost_sectors;
+    bool in_use;
+};
 
-/** @brief Internal module state. */
 typedef struct {
-    const struct flash_area *fa;
-    struct fcb fcb_inst;
-    struct flash_sector sectors[LOG_STORAGE_NUM_SECTORS];
-    ovyl_log_storage_metadata_t metadata;
+    const ovyl_log_storage_backend_api_t *backend;
     struct k_mutex mutex;
-    ovyl_log_storage_read_ctx_t read_head;
+    bool ready;
     volatile bool export_in_progress;
+    ovyl_log_storage_read_ctx_t read_head;
+    ovyl_log_storage_read_ctx_t export_ctx;
+    ovyl_log_storage_cursor_t cursors[CONFIG_OVYL_LOG_STORAGE_CURSOR_COUNT];
+    uint8_t export_buf[OVYL_LOG_STORAGE_FILTER_HDR_MAX + CONFIG_OVYL_LOG_STORAGE_EXPORT_CHUNK_SIZE];
+    ovyl_log_storage_export_filter_t export_filter;
+    uint32_t init_us;
+    uint32_t export_bytes;
+    uint32_t export_filtered;
+    uint32_t export_us;
 } prv_log_storage_state_t;
 
-static prv_log_storage_state_t prv_inst;
-
-/** @brief Convert a Zephyr log severity level to a printable name. */
-static const char *prv_get_log_level_name(uint8_t level)
-{
-    switch (level) {
-        case LOG_LEVEL_NONE:
-            return "OFF";
-        case LOG_LEVEL_ERR:
-            return "ERR";
-        case LOG_LEVEL_WRN:
-            return "WRN";
-        case LOG_LEVEL_INF:
-            return "INF";
-        case LOG_LEVEL_DBG:
-            return "DBG";
-        default:
-            return "UNK";
-    }
-}
-
-typedef struct {
-    const char *name;
-    uint8_t level;
-} prv_log_level_entry_t;
-
-static const prv_log_level_entry_t prv_log_levels[] = {
-    {"off", LOG_LEVEL_NONE},
-    {"err", LOG_LEVEL_ERR},
-    {"wrn", LOG_LEVEL_WRN},
-    {"inf", LOG_LEVEL_INF},
-    {"dbg", LOG_LEVEL_DBG},
+static prv_log_storage_state_t prv_inst = {
+    .backend = LOG_STORAGE_BACKEND,
 };
 
-/** @brief Resolve a textual log level into the matching table entry. */
-static const prv_log_level_entry_t *prv_find_log_level(const char *name)
+void ovyl_log_storage_readers_drop(bool (*lost)(const ovyl_log_storage_read_ctx_t *ctx, void *arg), void *arg)
 {
-    if (name == NULL) {
-        return NULL;
+    if ((lost == NULL) || lost(&prv_inst.read_head, arg)) {
+        memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
     }
 
-    size_t input_len = strlen(name);
+    if (lost == NULL) {
+        /* The export reader is bounded by its snapshot; only a clear moves it. */
+        memset(&prv_inst.export_ctx, 0, sizeof(prv_inst.export_ctx));
+    }
 
-    for (size_t i = 0; i < ARRAY_SIZE(prv_log_levels); i++) {
-        const char *candidate = prv_log_levels[i].name;
-        size_t cand_len = strlen(candidate);
+    for (size_t i = 0; i < ARRAY_SIZE(prv_inst.cursors); i++) {
+        ovyl_log_storage_cursor_t *cursor = &prv_inst.cursors[i];
 
-        if (input_len != cand_len) {
+        if (!cursor->in_use) {
             continue;
         }
 
-        bool match = true;
-        for (size_t j = 0; j < cand_len; j++) {
-            if ((char)tolower((unsigned char)name[j]) != candidate[j]) {
-                match = false;
-                break;
-            }
-        }
-
-        if (match) {
-            return &prv_log_levels[i];
+        if (lost == NULL) {
+            memset(&cursor->ctx, 0, sizeof(cursor->ctx));
+        } else if (lost(&cursor->ctx, arg)) {
+            cursor->lost_sectors++;
+            memset(&cursor->ctx, 0, sizeof(cursor->ctx));
         }
     }
-
-    return NULL;
 }
 
 int ovyl_log_storage_init(void)
 {
-    if (prv_inst.fa != NULL) {
+    if (prv_inst.ready) {
         return 0;
     }
 
-    int ret = flash_area_open(LOG_STORAGE_FLASH_AREA_ID, &prv_inst.fa);
-
-    if (ret < 0) {
-        LOG_ERR("Failed to open flash area (ID %d): %d", LOG_STORAGE_FLASH_AREA_ID, ret);
-        return ret;
-    }
+    uint32_t start_cycles = k_cycle_get_32();
 
-    uint32_t sector_count = LOG_STORAGE_NUM_SECTORS;
-    ret = flash_area_sectors(prv_inst.fa, &sector_count, prv_inst.sectors);
-    if (ret < 0) {
-        LOG_ERR("Failed to read flash sector info: %d", ret);
-        flash_area_close(prv_inst.fa);
-        prv_inst.fa = NULL;
-        return ret;
-    }
+    k_mutex_init(&prv_inst.mutex);
 
-    if (sector_count > ARRAY_SIZE(prv_inst.sectors)) {
-        LOG_ERR("Partition reported %u sectors, expected <= %zu",
-                sector_count,
-                ARRAY_SIZE(prv_inst.sectors));
-        flash_area_close(prv_inst.fa);
-        prv_inst.fa = NULL;
-        return -E2BIG;
-    }
+    int ret = prv_inst.backend->init(&prv_inst.mutex);
 
-    memset(&prv_inst.fcb_inst, 0, sizeof(prv_inst.fcb_inst));
-    prv_inst.fcb_inst.f_magic = LOG_STORAGE_FCB_MAGIC;
-    prv_inst.fcb_inst.f_sectors = prv_inst.sectors;
-    prv_inst.fcb_inst.f_sector_cnt = (uint8_t)sector_count;
-    prv_inst.fcb_inst.f_scratch_cnt = 1U;
+    prv_inst.init_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
 
-    ret = fcb_init(LOG_STORAGE_FLASH_AREA_ID, &prv_inst.fcb_inst);
     if (ret < 0) {
-        LOG_ERR("Failed to initialize FCB: %d", ret);
-        flash_area_close(prv_inst.fa);
-        prv_inst.fa = NULL;
+        LOG_ERR("Failed to initialize storage backend: %d", ret);
         return ret;
     }
 
-    k_mutex_init(&prv_inst.mutex);
-    ovyl_log_storage_reset_read();
+    memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
     prv_inst.export_in_progress = false;
+    prv_inst.ready = true;
 
     return 0;
 }
@@ -189,222 +134,627 @@ int ovyl_log_storage_add_data(const void *buf, size_t buf_size)
         return 0;
     }
 
-    if (prv_inst.export_in_progress) {
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    return prv_inst.backend->append(buf, buf_size);
+}
+
+int ovyl_log_storage_add_record(const ovyl_log_storage_record_hdr_t *hdr, uint8_t *record, size_t payload_len)
+{
+    if (prv_inst.backend->append_record == NULL) {
+        return -ENOTSUP;
+    }
+
+    if ((hdr == NULL) || (record == NULL) || (payload_len > CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE) ||
+        (hdr->level > LOG_LEVEL_DBG) || ((hdr->flags & ~OVYL_LOG_STORAGE_RECORD_FLAGS_KNOWN) != 0U)) {
+        return -EINVAL;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    return prv_inst.backend->append_record(hdr, record, payload_len);
+}
+
+int ovyl_log_storage_flush(void)
+{
+    if (!prv_inst.ready) {
         return 0;
     }
 
-    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    return prv_inst.backend->flush();
+}
+
+int ovyl_log_storage_panic(void)
+{
+    if (!prv_inst.ready) {
+        return 0;
+    }
+
+    return prv_inst.backend->panic();
+}
+
+int ovyl_log_storage_fetch_data(void *dst, size_t dest_size, size_t *out_size)
+{
+    if (dst == NULL || out_size == NULL) {
+        return -EINVAL;
+    }
 
+    if (!prv_inst.ready) {
+        return -ENOENT;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        if (!prv_inst.export_in_progress) {
-            LOG_WRN("Failed to lock mutex.");
-        }
+        LOG_WRN("Failed to lock mutex.");
         return -EBUSY;
     }
 
-    struct fcb_entry loc = {0};
+    (void)prv_inst.backend->sync();
 
-    ret = fcb_append(&prv_inst.fcb_inst, buf_size, &loc);
+    ret = prv_inst.backend->read(&prv_inst.read_head, true, dst, dest_size, out_size);
 
-    if (ret == -ENOSPC) {
-        ret = fcb_rotate(&prv_inst.fcb_inst);
+    k_mutex_unlock(&prv_inst.mutex);
 
-        if (ret < 0) {
-            if (!prv_inst.export_in_progress) {
-                LOG_ERR("Failed to rotate sectors: %d", ret);
-            }
-            k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
 
-            return ret;
-        }
+int ovyl_log_storage_fetch_bulk(void *dst, size_t dest_size, uint32_t flags, size_t *out_size)
+{
+    if (dst == NULL || out_size == NULL) {
+        return -EINVAL;
+    }
 
-        ret = fcb_append(&prv_inst.fcb_inst, buf_size, &loc);
+    if (!prv_inst.ready) {
+        return -ENOENT;
     }
 
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        if (!prv_inst.export_in_progress) {
-            LOG_ERR("Failed to get location to write to: %d", ret);
-        }
-        (void)fcb_clear(&prv_inst.fcb_inst);
-        memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
-        k_mutex_unlock(&prv_inst.mutex);
-        return ret;
+        LOG_WRN("Failed to lock mutex.");
+        return -EBUSY;
     }
 
-    ret = flash_area_write(prv_inst.fa, FCB_ENTRY_FA_DATA_OFF(loc), buf, buf_size);
+    (void)prv_inst.backend->sync();
+
+    ret = prv_inst.backend->read_bulk(&prv_inst.read_head,
+                                      true,
+                                      dst,
+                                      dest_size,
+                                      flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR,
+                                      out_size);
 
+    k_mutex_unlock(&prv_inst.mutex);
+
+    return ret;
+}
+
+void ovyl_log_storage_reset_read(void)
+{
+    if (!prv_inst.ready) {
+        return;
+    }
+
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        LOG_WRN("Failed to lock mutex.");
+        return;
+    }
+
+    memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
+    prv_inst.backend->snapshot_rewind();
+
+    k_mutex_unlock(&prv_inst.mutex);
+}
+
+int ovyl_log_storage_seek_time(uint16_t boot_id, uint64_t uptime_ms)
+{
+    if (prv_inst.backend->seek_time == NULL) {
+        return -ENOTSUP;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENOENT;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        if (!prv_inst.export_in_progress) {
-            LOG_ERR("Failed to write to flash: %d", ret);
+        return -EBUSY;
+    }
+
+    (void)prv_inst.backend->sync();
+
+    ret = prv_inst.backend->seek_time(&prv_inst.read_head, boot_id, uptime_ms);
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+uint16_t ovyl_log_storage_boot_id(void)
+{
+    return (prv_inst.backend->boot_id != NULL) ? prv_inst.backend->boot_id() : 0U;
+}
+
+int ovyl_log_storage_cursor_open(const char *name, ovyl_log_storage_cursor_t **cursor)
+{
+    if ((name == NULL) || (cursor == NULL)) {
+        return -EINVAL;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        return -EBUSY;
+    }
+
+    ovyl_log_storage_cursor_t *free_slot = NULL;
+    int ret = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(prv_inst.cursors); i++) {
+        ovyl_log_storage_cursor_t *c = &prv_inst.cursors[i];
+
+        if (!c->in_use) {
+            free_slot = (free_slot == NULL) ? c : free_slot;
+        } else if (strcmp(c->name, name) == 0) {
+            ret = -EEXIST;
+            break;
         }
-        k_mutex_unlock(&prv_inst.mutex);
-        return ret;
     }
 
-    ret = fcb_append_finish(&prv_inst.fcb_inst, &loc);
+    if ((ret == 0) && (free_slot == NULL)) {
+        ret = -ENOMEM;
+    }
+
+    if (ret == 0) {
+        memset(free_slot, 0, sizeof(*free_slot));
+        free_slot->name = name;
+        free_slot->in_use = true;
+        *cursor = free_slot;
+    }
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+int ovyl_log_storage_cursor_fetch(ovyl_log_storage_cursor_t *cursor,
+                                  void *dst,
+                                  size_t dest_size,
+                                  size_t *out_size)
+{
+    if ((cursor == NULL) || !cursor->in_use || (dst == NULL) || (out_size == NULL)) {
+        return -EINVAL;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        if (!prv_inst.export_in_progress) {
-            LOG_ERR("Failed to finalize write: %d", ret);
-        }
-        k_mutex_unlock(&prv_inst.mutex);
-        return ret;
+        return -EBUSY;
     }
 
+    (void)prv_inst.backend->sync();
+
+    ret = prv_inst.backend->read(&cursor->ctx, false, dst, dest_size, out_size);
+
     k_mutex_unlock(&prv_inst.mutex);
-    return 0;
+    return ret;
 }
 
-int ovyl_log_storage_fetch_data(void *dst, size_t dest_size, size_t *out_size)
+int ovyl_log_storage_cursor_fetch_bulk(ovyl_log_storage_cursor_t *cursor,
+                                       void *dst,
+                                       size_t dest_size,
+                                       uint32_t flags,
+                                       size_t *out_size)
 {
-    if (dst == NULL || out_size == NULL) {
+    if ((cursor == NULL) || !cursor->in_use || (dst == NULL) || (out_size == NULL)) {
         return -EINVAL;
     }
 
     int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        LOG_WRN("Failed to lock mutex.");
         return -EBUSY;
     }
 
-    ovyl_log_storage_read_ctx_t *ctx = &prv_inst.read_head;
-    struct fcb_entry *loc = &prv_inst.read_head.head;
+    (void)prv_inst.backend->sync();
 
-    if (loc->fe_sector == NULL || (loc->fe_sector && ctx->read_bytes == loc->fe_data_len)) {
-        ctx->read_bytes = 0;
-        ret = fcb_getnext(&prv_inst.fcb_inst, loc);
+    ret = prv_inst.backend->read_bulk(&cursor->ctx,
+                                      false,
+                                      dst,
+                                      dest_size,
+                                      flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR,
+                                      out_size);
 
-        if (ret < 0) {
-            k_mutex_unlock(&prv_inst.mutex);
-            return ret;
-        }
+    k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+int ovyl_log_storage_cursor_rewind(ovyl_log_storage_cursor_t *cursor)
+{
+    if ((cursor == NULL) || !cursor->in_use) {
+        return -EINVAL;
     }
 
-    uint16_t len = ctx->head.fe_data_len - ctx->read_bytes;
-    if (len > dest_size) {
-        len = dest_size;
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        return -EBUSY;
     }
 
-    ret = flash_area_read(prv_inst.fa, FCB_ENTRY_FA_DATA_OFF((*loc)) + ctx->read_bytes, dst, len);
+    memset(&cursor->ctx, 0, sizeof(cursor->ctx));
+    cursor->lost_sectors = 0U;
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return 0;
+}
 
+uint32_t ovyl_log_storage_cursor_lost_sectors(const ovyl_log_storage_cursor_t *cursor)
+{
+    return ((cursor != NULL) && cursor->in_use) ? cursor->lost_sectors : 0U;
+}
+
+int ovyl_log_storage_cursor_close(ovyl_log_storage_cursor_t *cursor)
+{
+    if ((cursor == NULL) || !cursor->in_use) {
+        return -EINVAL;
+    }
+
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        return -EBUSY;
+    }
+
+    memset(cursor, 0, sizeof(*cursor));
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return 0;
+}
+
+int ovyl_log_storage_upload_fetch(void *dst, size_t dest_size, size_t *out_size)
+{
+    if ((dst == NULL) || (out_size == NULL)) {
+        return -EINVAL;
+    }
+
+    if (prv_inst.backend->upload_fetch == NULL) {
+        return -ENOTSUP;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENOENT;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        LOG_ERR("Failed to read from flash %d", ret);
-        k_mutex_unlock(&prv_inst.mutex);
-        return -EIO;
+        return -EBUSY;
     }
 
-    ctx->read_bytes += len;
-    *out_size = len;
+    (void)prv_inst.backend->sync();
+
+    ret = prv_inst.backend->upload_fetch(dst, dest_size, out_size);
 
     k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+/** @brief Run one of the upload watermark operations under the mutex. */
+static int prv_upload_op(int (*op)(void))
+{
+    if (op == NULL) {
+        return -ENOTSUP;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        return -EBUSY;
+    }
 
+    ret = op();
+
+    k_mutex_unlock(&prv_inst.mutex);
     return ret;
 }
 
-void ovyl_log_storage_reset_read(void)
+int ovyl_log_storage_upload_ack(void)
 {
-    memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
+    return prv_upload_op(prv_inst.backend->upload_ack);
+}
+
+int ovyl_log_storage_upload_rewind(void)
+{
+    return prv_upload_op(prv_inst.backend->upload_rewind);
+}
+
+int ovyl_log_storage_upload_reset(void)
+{
+    return prv_upload_op(prv_inst.backend->upload_reset);
 }
 
 int ovyl_log_storage_clear(void)
 {
-    k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
 
-    int ret = fcb_clear(&prv_inst.fcb_inst);
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        LOG_ERR("Failed to clear FCB: %d", ret);
-        k_mutex_unlock(&prv_inst.mutex);
-        return ret;
+        return -EBUSY;
     }
 
-    memset(&prv_inst.read_head, 0, sizeof(prv_inst.read_head));
+    ret = prv_inst.backend->clear();
+
+    if (ret < 0) {
+        LOG_ERR("Failed to clear log storage: %d", ret);
+    } else {
+        ovyl_log_storage_readers_drop(NULL, NULL);
+    }
 
     k_mutex_unlock(&prv_inst.mutex);
-    return 0;
+    return ret;
 }
 
 void ovyl_log_storage_set_export_in_progress(bool in_progress)
 {
+    if (!prv_inst.ready) {
+        return;
+    }
+
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        LOG_WRN("Failed to lock mutex.");
+        return;
+    }
+
+    if (in_progress) {
+        (void)prv_inst.backend->sync();
+        prv_inst.backend->snapshot_begin();
+    } else {
+        prv_inst.backend->snapshot_end();
+    }
+
     prv_inst.export_in_progress = in_progress;
+    k_mutex_unlock(&prv_inst.mutex);
 }
 
-void ovyl_log_storage_init_log_level(void)
+int ovyl_log_storage_export(const ovyl_log_storage_sink_t *sink, const ovyl_log_storage_filter_t *filter)
 {
-    uint8_t log_level;
-    bool use_default = false;
+    static const ovyl_log_storage_filter_t no_filter;
 
-    if (ovyl_config_mgr_get_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level))) {
-        if (log_level > LOG_LEVEL_DBG) {
-            use_default = true;
-        }
-    } else {
-        use_default = true;
+    if ((sink == NULL) || (sink->api == NULL) || (sink->api->write == NULL)) {
+        return -EINVAL;
+    }
+
+    filter = (filter != NULL) ? filter : &no_filter;
+
+    bool record_filter = (filter->flags & OVYL_LOG_STORAGE_FILTER_RECORD_FLAGS) != 0U;
+    bool entry_hdr = (filter->flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR) != 0U;
+
+    if (record_filter && entry_hdr) {
+        /* Dropping records would leave the entry length prefixes wrong. */
+        return -EINVAL;
     }
 
-    if (use_default) {
-        log_level = CONFIG_LOG_DEFAULT_LEVEL;
-        ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level));
+    if (((filter->flags & OVYL_LOG_STORAGE_FILTER_LEVEL) != 0U) &&
+        ((filter->max_level < LOG_LEVEL_ERR) || (filter->max_level > LOG_LEVEL_DBG))) {
+        return -EINVAL;
+    }
+
+    if (((filter->flags & OVYL_LOG_STORAGE_FILTER_SOURCE) != 0U) &&
+        ((filter->source_cnt == 0U) || (filter->source_cnt > OVYL_LOG_STORAGE_FILTER_MAX_SOURCES))) {
+        return -EINVAL;
     }
 
-    if (log_level < LOG_RUNTIME_MIN_LEVEL) {
-        log_level = LOG_RUNTIME_MIN_LEVEL;
-        LOG_WRN("Persisted log level is below minimum; clamping to %u", log_level);
-        ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level));
+    if (!prv_inst.ready) {
+        return -ENODEV;
     }
 
-    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
-    uint32_t set_count = 0;
+    const ovyl_log_storage_backend_api_t *backend = prv_inst.backend;
+    ovyl_log_storage_read_ctx_t *ctx = &prv_inst.export_ctx;
+    ovyl_log_storage_export_filter_t *f = &prv_inst.export_filter;
+    uint8_t *chunk = &prv_inst.export_buf[OVYL_LOG_STORAGE_FILTER_HDR_MAX];
+    uint32_t start_cycles = k_cycle_get_32();
+    uint32_t export_bytes = 0U;
+    uint32_t filtered = 0U;
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    if (prv_inst.export_in_progress) {
+        k_mutex_unlock(&prv_inst.mutex);
+        return -EBUSY;
+    }
+
+    (void)backend->sync();
+    backend->snapshot_begin();
+    memset(ctx, 0, sizeof(*ctx));
+    ovyl_log_storage_filter_begin(f, filter);
+
+    if (backend->export_begin != NULL) {
+        ret = backend->export_begin(ctx, f);
+    } else if ((filter->flags & (OVYL_LOG_STORAGE_FILTER_SINCE | OVYL_LOG_STORAGE_FILTER_UNTIL |
+                                 OVYL_LOG_STORAGE_FILTER_BOOT)) != 0U) {
+        /* Time and boot filters need a backend that indexes stored data by time. */
+        ret = -ENOTSUP;
+    }
+
+    if (ret < 0) {
+        backend->snapshot_end();
+        k_mutex_unlock(&prv_inst.mutex);
+        return ret;
+    }
+
+    prv_inst.export_in_progress = true;
+    k_mutex_unlock(&prv_inst.mutex);
+
+    while (ret == 0) {
+        size_t credit;
+        size_t len = 0U;
+        uint8_t *out = chunk;
+
+        /* A bulk entry header needs room for at least one payload byte behind it. */
+        ret = ovyl_log_storage_export_credit(sink, entry_hdr ? OVYL_LOG_STORAGE_BULK_HDR_SIZE : 0U, &credit);
+        if (ret < 0) {
+            break;
+        }
+
+        ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+        if (ret < 0) {
+            ret = -EBUSY;
+            break;
+        }
+
+        if (backend->export_read != NULL) {
+            ret = backend->export_read(ctx, chunk, credit, filter->flags, &len);
+        } else {
+            ret = backend->read_bulk(ctx, true, chunk, credit, filter->flags, &len);
+        }
+
+        k_mutex_unlock(&prv_inst.mutex);
+
+        if (ret == -ENOENT) {
+            /* End of the snapshot: release a line prefix the filter still holds. */
+            out = prv_inst.export_buf;
+            len = record_filter ? ovyl_log_storage_filter_finish(f, out) : 0U;
+            ret = ovyl_log_storage_export_write(sink, out, len);
+            export_bytes += (ret == 0) ? len : 0U;
+            break;
+        }
+
+        if (ret < 0) {
+            break;
+        }
+
+        if (record_filter) {
+            size_t kept;
 
-    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
-        uint32_t result_level = log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, log_level);
-        if (result_level == log_level) {
-            set_count++;
+            out = prv_inst.export_buf;
+            kept = ovyl_log_storage_filter_records(f, out, chunk, len);
+            filtered += (len > kept) ? (uint32_t)(len - kept) : 0U;
+            len = kept;
         }
+
+        ret = ovyl_log_storage_export_write(sink, out, len);
+        if (ret < 0) {
+            break;
+        }
+
+        export_bytes += len;
+    }
+
+    if ((sink->api->flush != NULL) && (ret == 0)) {
+        ret = sink->api->flush(sink->ctx);
     }
 
-    LOG_INF("Log level initialized: %u (applied to %u/%u modules)", log_level, set_count, source_count);
+    /* Wait for the mutex so rotation is never left blocked by a stale snapshot. */
+    (void)k_mutex_lock(&prv_inst.mutex, K_FOREVER);
+    backend->snapshot_end();
+    prv_inst.export_in_progress = false;
+    prv_inst.export_bytes = export_bytes;
+    prv_inst.export_filtered = filtered;
+    prv_inst.export_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+    k_mutex_unlock(&prv_inst.mutex);
+
+    return ret;
 }
 
-int ovyl_log_storage_set_log_level(uint8_t level)
+int ovyl_log_storage_get_stats(ovyl_log_storage_stats_t *stats)
 {
-    if (level > LOG_LEVEL_DBG) {
-        LOG_ERR("Invalid log level: %u. Valid levels: %u=ERR, %u=WRN, %u=INF, %u=DBG",
-                level,
-                LOG_LEVEL_ERR,
-                LOG_LEVEL_WRN,
-                LOG_LEVEL_INF,
-                LOG_LEVEL_DBG);
+    if (stats == NULL) {
         return -EINVAL;
     }
 
-    uint8_t clamped_level = level;
-    if (clamped_level < LOG_RUNTIME_MIN_LEVEL) {
-        clamped_level = LOG_RUNTIME_MIN_LEVEL;
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        return -EBUSY;
     }
 
-    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+    memset(stats, 0, sizeof(*stats));
 
-    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
-        log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, clamped_level);
+    if (prv_inst.ready) {
+        prv_inst.backend->get_stats(stats);
     }
 
-    if (!ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &clamped_level, sizeof(clamped_level))) {
-        LOG_ERR("Failed to save log level to config");
-        return -EIO;
+    stats->export_bytes = prv_inst.export_bytes;
+    stats->export_filtered = prv_inst.export_filtered;
+    stats->export_us = prv_inst.export_us;
+    stats->init_us = prv_inst.init_us;
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return 0;
+}
+
+void ovyl_log_storage_reset_stats(void)
+{
+    if (k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        return;
     }
 
-    if (clamped_level != level) {
-        LOG_WRN("Requested level %u clamped to minimum runtime level %u", level, clamped_level);
+    if (prv_inst.ready) {
+        prv_inst.backend->reset_stats();
     }
 
-    const char *level_name = prv_get_log_level_name(clamped_level);
-    LOG_INF("Log level set to: %s (%u)", level_name, clamped_level);
+    prv_inst.export_bytes = 0U;
+    prv_inst.export_filtered = 0U;
+    prv_inst.export_us = 0U;
 
-    return 0;
+    k_mutex_unlock(&prv_inst.mutex);
 }
 
-#ifdef CONFIG_SHELL
+int ovyl_log_storage_set_erase_ahead(bool enable)
+{
+    if (prv_inst.backend->set_erase_ahead == NULL) {
+        return -ENOTSUP;
+    }
 
-#include <zephyr/shell/shell.h>
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    ret = prv_inst.backend->set_erase_ahead(enable);
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+int ovyl_log_storage_get_wear(ovyl_log_storage_wear_status_t *status)
+{
+    if (prv_inst.backend->get_wear == NULL) {
+        return -ENOTSUP;
+    }
+
+    if (status == NULL) {
+        return -EINVAL;
+    }
+
+    if (!prv_inst.ready) {
+        return -ENODEV;
+    }
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    ret = prv_inst.backend->get_wear(status);
+
+    k_mutex_unlock(&prv_inst.mutex);
+    return ret;
+}
+
+uint8_t ovyl_log_storage_wear_level(void)
+{
+    return (prv_inst.backend->wear_level != NULL) ? prv_inst.backend->wear_level() : LOG_LEVEL_DBG;
+}
+
+#ifdef CONFIG_SHELL
 
 /** @brief Shell command handler that reports export-in-progress state. */
 static int prv_shell_print_export_status(const struct shell *sh, size_t argc, char **argv)
@@ -435,142 +785,264 @@ static int prv_shell_log_storage_clear(const struct shell *sh, size_t argc, char
     return 0;
 }
 
-/** @brief Shell command handler that streams stored logs to the shell. */
-static int prv_shell_log_storage_export(const struct shell *sh, size_t argc, char **argv)
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/** @brief Parse "[boot:]ms"; the boot defaults to the current one. */
+static int prv_shell_parse_time(const char *arg, uint16_t *boot, uint64_t *ms)
 {
-    ARG_UNUSED(argc);
-    ARG_UNUSED(argv);
+    char *end = NULL;
+    unsigned long long value = strtoull(arg, &end, 10);
+    uint16_t boot_id = ovyl_log_storage_boot_id();
 
-    uint8_t buffer[64];
-    struct fcb_entry entry = {0};
-    bool previous_export_state = prv_inst.export_in_progress;
-
-    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
-    if (ret < 0) {
-        shell_error(sh, "Unable to lock log storage: %d", ret);
-        return ret;
+    if (end == arg) {
+        return -EINVAL;
     }
 
-    prv_inst.export_in_progress = true;
+    if (*end == ':') {
+        const char *ms_arg = end + 1;
 
-    ret = fcb_getnext(&prv_inst.fcb_inst, &entry);
-    if (ret == -ENOENT) {
-        shell_print(sh, "No stored log entries.");
-        ret = 0;
-        goto out;
-    }
-
-    while (ret >= 0) {
-        uint32_t offset = FCB_ENTRY_FA_DATA_OFF(entry);
-        uint16_t remaining = entry.fe_data_len;
-        uint32_t pos = 0U;
-
-        while (remaining > 0U) {
-            uint16_t chunk = MIN((uint16_t)sizeof(buffer), remaining);
-            int read_rc = flash_area_read(prv_inst.fa, offset + pos, buffer, chunk);
-            if (read_rc < 0) {
-                shell_error(sh, "Failed to read log entry: %d", read_rc);
-                ret = read_rc;
-                goto out;
-            }
+        if (value > UINT16_MAX) {
+            return -EINVAL;
+        }
 
-            char out_chunk[sizeof(buffer) + 1];
-            memcpy(out_chunk, buffer, chunk);
-            out_chunk[chunk] = '\0';
-            shell_fprintf(sh, SHELL_VT100_COLOR_DEFAULT, "%s", out_chunk);
-            remaining -= chunk;
-            pos += chunk;
+        boot_id = (uint16_t)value;
+        value = strtoull(ms_arg, &end, 10);
+        if (end == ms_arg) {
+            return -EINVAL;
         }
+    }
 
-        ret = fcb_getnext(&prv_inst.fcb_inst, &entry);
+    if (*end != '\0') {
+        return -EINVAL;
     }
 
-    if (ret == -ENOENT) {
-        ret = 0;
+    *boot = boot_id;
+    *ms = value;
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_TIME_INDEX */
+
+/** @brief Sink write callback that prints exported bytes on the shell. */
+static int prv_shell_sink_write(void *ctx, const uint8_t *data, size_t len)
+{
+    const struct shell *sh = ctx;
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY) || defined(CONFIG_OVYL_LOG_STORAGE_RECORD_HDR)
+    /* Binary records are emitted as hex lines for scripts/log_storage_decode.py. */
+    char line[(32U * 2U) + 1];
+
+    while (len > 0U) {
+        size_t chunk = MIN(len, 32U);
+
+        (void)bin2hex(data, chunk, line, sizeof(line));
+        shell_print(sh, "%s", line);
+        data += chunk;
+        len -= chunk;
     }
+#else
+    shell_fprintf(sh, SHELL_VT100_COLOR_DEFAULT, "%.*s", (int)len, (const char *)data);
+#endif
 
-out:
-    prv_inst.export_in_progress = previous_export_state;
-    k_mutex_unlock(&prv_inst.mutex);
-    return ret;
+    return 0;
 }
 
-/** @brief Print a table of compiled and runtime log levels for each module. */
-static int prv_shell_list_module_log_levels(const struct shell *sh)
+static const ovyl_log_storage_sink_api_t prv_shell_sink_api = {
+    .write = prv_shell_sink_write,
+};
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+#define LOG_STORAGE_SHELL_EXPORT_OPTIONS                                                            \
+    " [--level <lvl>] [--module <name>]... [--boot <id>] [--since [boot:]ms] [--until [boot:]ms]"
+#define LOG_STORAGE_SHELL_EXPORT_ARGS 16
+#else
+#define LOG_STORAGE_SHELL_EXPORT_OPTIONS " [--level <lvl>] [--module <name>]..."
+#define LOG_STORAGE_SHELL_EXPORT_ARGS 10
+#endif
+
+/** @brief Apply one "--option value" pair of the export command to @p filter. */
+static int prv_shell_parse_export_option(const char *option, const char *value, ovyl_log_storage_filter_t *filter)
 {
-    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+    if (value == NULL) {
+        return -EINVAL;
+    }
+
+    if (strcmp(option, "--level") == 0) {
+        uint8_t level;
+
+        if ((ovyl_log_storage_level_parse(value, &level) < 0) || (level == LOG_LEVEL_NONE)) {
+            return -EINVAL;
+        }
 
-    shell_print(sh, "Module Log Levels (%u modules):", source_count);
-    shell_print(sh, "%-24s %-8s %-8s", "Module", "Runtime", "Compiled");
-    shell_print(sh, "%-24s %-8s %-8s", "------", "-------", "--------");
+        filter->max_level = level;
+        filter->flags |= OVYL_LOG_STORAGE_FILTER_LEVEL;
+        return 0;
+    }
 
-    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
-        const char *source_name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id);
-        uint32_t runtime_level = log_filter_get(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, true);
-        uint32_t compiled_level = log_filter_get(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, false);
+    if (strcmp(option, "--module") == 0) {
+        uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
 
-        const char *runtime_name = prv_get_log_level_name(runtime_level);
-        const char *compiled_name = prv_get_log_level_name(compiled_level);
+        if (filter->source_cnt >= OVYL_LOG_STORAGE_FILTER_MAX_SOURCES) {
+            return -ENOMEM;
+        }
+
+        for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+            const char *source_name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id);
+
+            if ((source_name != NULL) && (strcmp(source_name, value) == 0)) {
+                filter->sources[filter->source_cnt++] = (uint16_t)source_id;
+                filter->flags |= OVYL_LOG_STORAGE_FILTER_SOURCE;
+                return 0;
+            }
+        }
 
-        shell_print(sh,
-                    "%-24s %-8s %-8s",
-                    source_name ? source_name : "unknown",
-                    runtime_name,
-                    compiled_name);
+        return -ENOENT;
     }
 
-    shell_print(sh, "\nUse 'log_storage set_log_level <level>' to change runtime levels for all modules.");
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    if (strcmp(option, "--boot") == 0) {
+        char *end = NULL;
+        unsigned long boot = strtoul(value, &end, 10);
 
-    return 0;
+        if ((end == value) || (*end != '\0') || (boot > UINT16_MAX)) {
+            return -EINVAL;
+        }
+
+        filter->boot = (uint16_t)boot;
+        filter->flags |= OVYL_LOG_STORAGE_FILTER_BOOT;
+        return 0;
+    }
+
+    if (strcmp(option, "--since") == 0) {
+        filter->flags |= OVYL_LOG_STORAGE_FILTER_SINCE;
+        return prv_shell_parse_time(value, &filter->since_boot, &filter->since_ms);
+    }
+
+    if (strcmp(option, "--until") == 0) {
+        filter->flags |= OVYL_LOG_STORAGE_FILTER_UNTIL;
+        return prv_shell_parse_time(value, &filter->until_boot, &filter->until_ms);
+    }
+#endif
+
+    return -EINVAL;
 }
 
-/** @brief Shell helper that lists available severity names and current levels. */
-static int prv_shell_log_storage_list_levels(const struct shell *sh, size_t argc, char **argv)
+/** @brief Shell command handler that streams stored logs to the shell. */
+static int prv_shell_log_storage_export(const struct shell *sh, size_t argc, char **argv)
 {
-    ARG_UNUSED(argc);
-    ARG_UNUSED(argv);
+    ovyl_log_storage_filter_t filter = {0};
+    ovyl_log_storage_sink_t sink = {
+        .api = &prv_shell_sink_api,
+        .ctx = (void *)sh,
+    };
+
+    for (size_t i = 1; i < argc; i += 2) {
+        int ret = prv_shell_parse_export_option(argv[i], ((i + 1) < argc) ? argv[i + 1] : NULL, &filter);
+
+        if (ret < 0) {
+            shell_error(sh, "Invalid option '%s'.", argv[i]);
+            shell_error(sh, "usage: log_storage export" LOG_STORAGE_SHELL_EXPORT_OPTIONS);
+            return ret;
+        }
+    }
+
+    int ret = ovyl_log_storage_export(&sink, &filter);
 
-    shell_print(sh, "Available severity levels:");
-    for (size_t i = 0; i < ARRAY_SIZE(prv_log_levels); i++) {
-        shell_print(sh, "  %s", prv_log_levels[i].name);
+    if (ret == -EBUSY) {
+        shell_error(sh, "Another export is in progress.");
+    } else if (ret < 0) {
+        shell_error(sh, "Failed to export logs: %d", ret);
+    } else if ((prv_inst.export_bytes == 0U) && (prv_inst.export_filtered > 0U)) {
+        shell_print(sh, "No stored log entries matched the filter.");
+    } else if (prv_inst.export_bytes == 0U) {
+        shell_print(sh, "No stored log entries.");
     }
 
-    shell_print(sh, "\nModule log level summary:");
-    return prv_shell_list_module_log_levels(sh);
+    return ret;
 }
 
-/** @brief Shell command handler for updating the runtime log level. */
-static int prv_shell_log_storage_set_level_cmd(const struct shell *sh, size_t argc, char **argv)
+/** @brief Shell command handler that prints (or resets) log storage counters. */
+static int prv_shell_log_storage_stats(const struct shell *sh, size_t argc, char **argv)
 {
-    if (argc < 2) {
-        shell_error(sh, "Missing level argument. Usage: log_storage set_log_level <err|wrn|inf|dbg|1-4>");
-        return -EINVAL;
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        ovyl_log_storage_reset_stats();
+        shell_print(sh, "Log storage stats reset.");
+        return 0;
     }
 
-    uint8_t level;
-    const prv_log_level_entry_t *entry = prv_find_log_level(argv[1]);
+    ovyl_log_storage_stats_t stats;
 
-    if (entry != NULL) {
-        level = entry->level;
-    } else {
-        char *endptr = NULL;
-        long numeric = strtol(argv[1], &endptr, 10);
-        if ((endptr == NULL) || (*endptr != '\0') || numeric < LOG_RUNTIME_MIN_LEVEL || numeric > LOG_LEVEL_DBG) {
-            shell_error(sh, "Invalid level '%s'. Use one of: err, wrn, inf, dbg, or 1-4.", argv[1]);
-            return -EINVAL;
+    int ret = ovyl_log_storage_get_stats(&stats);
+    if (ret < 0) {
+        shell_error(sh, "Unable to read log storage stats: %d", ret);
+        return ret;
+    }
+
+    if (prv_inst.ready) {
+        ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+        if (ret < 0) {
+            shell_error(sh, "Unable to lock log storage: %d", ret);
+            return ret;
         }
-        level = (uint8_t)numeric;
+
+        prv_inst.backend->shell_stats(sh, &stats);
+        k_mutex_unlock(&prv_inst.mutex);
+    }
+
+    shell_print(sh, "Dropped during export: %u", stats.export_dropped);
+    if (stats.export_us > 0U) {
+        shell_print(sh, "Last export:           %u bytes in %u ms (%u KB/s)",
+                    stats.export_bytes,
+                    stats.export_us / 1000U,
+                    (uint32_t)(((uint64_t)stats.export_bytes * 1000000U) / (stats.export_us * 1024ULL)));
+        shell_print(sh, "  Filtered out:        %u bytes", stats.export_filtered);
     }
 
-    int ret = ovyl_log_storage_set_log_level(level);
+    shell_print(sh, "Init:                  %u us", stats.init_us);
+
+    return 0;
+}
+
+/** @brief Shell command handler that lists open read cursors. */
+static int prv_shell_log_storage_cursors(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    const char *unit = prv_inst.backend->unit;
+
+    int ret = k_mutex_lock(&prv_inst.mutex, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
     if (ret < 0) {
-        shell_error(sh, "Failed to set log level: %d", ret);
+        shell_error(sh, "Unable to lock log storage: %d", ret);
         return ret;
     }
 
-    uint8_t clamped = level < LOG_RUNTIME_MIN_LEVEL ? LOG_RUNTIME_MIN_LEVEL : level;
-    const char *name = prv_get_log_level_name(clamped);
-    shell_print(sh, "Log level set to %s (%u).", name, (unsigned int)clamped);
+    size_t open_count = 0U;
+
+    for (size_t i = 0; i < ARRAY_SIZE(prv_inst.cursors); i++) {
+        const ovyl_log_storage_cursor_t *cursor = &prv_inst.cursors[i];
+        uint32_t pos_unit;
+        uint32_t pos_offset;
+
+        if (!cursor->in_use) {
+            continue;
+        }
+
+        open_count++;
+        if (prv_inst.backend->position(&cursor->ctx, &pos_unit, &pos_offset) < 0) {
+            shell_print(sh, "%-16s at oldest entry, lost %ss %u", cursor->name, unit, cursor->lost_sectors);
+        } else {
+            shell_print(sh, "%-16s %s %u offset %u, lost %ss %u",
+                        cursor->name,
+                        unit,
+                        pos_unit,
+                        pos_offset,
+                        unit,
+                        cursor->lost_sectors);
+        }
+    }
+
+    k_mutex_unlock(&prv_inst.mutex);
+
+    shell_print(sh, "%zu of %u cursors open.", open_count, CONFIG_OVYL_LOG_STORAGE_CURSOR_COUNT);
     return 0;
 }
 
@@ -593,28 +1065,33 @@ SHELL_STATIC_SUBCMD_SET_CREATE(log_storage_cmds,
                                              0),
                                SHELL_CMD_ARG(export,
                                              NULL,
-                                             "Stream stored log entries as plain text.\n"
+                                             "Stream stored log entries as plain text\n"
+                                             "(hex lines with dictionary format or record\n"
+                                             "headers), optionally keeping only records up\n"
+                                             "to a level, from given modules or from one boot.\n"
                                              "usage:\n"
-                                             "$ log_storage export\n",
+                                             "$ log_storage export" LOG_STORAGE_SHELL_EXPORT_OPTIONS "\n",
                                              prv_shell_log_storage_export,
                                              1,
-                                             0),
-                               SHELL_CMD_ARG(list_log_levels,
+                                             LOG_STORAGE_SHELL_EXPORT_ARGS),
+                               SHELL_CMD_ARG(stats,
                                              NULL,
-                                             "List current module log levels and available severities.\n"
+                                             "Print log storage counters.\n"
                                              "usage:\n"
-                                             "$ log_storage list_log_levels\n",
-                                             prv_shell_log_storage_list_levels,
+                                             "$ log_storage stats [reset]\n",
+                                             prv_shell_log_storage_stats,
                                              1,
-                                             0),
-                               SHELL_CMD_ARG(set_log_level,
+                                             1),
+                               SHELL_CMD_ARG(cursors,
                                              NULL,
-                                             "Set runtime log level for all modules (minimum 'err').\n"
+                                             "List open read cursors.\n"
                                              "usage:\n"
-                                             "$ log_storage set_log_level <err|wrn|inf|dbg|1-4>\n",
-                                             prv_shell_log_storage_set_level_cmd,
-                                             2,
+                                             "$ log_storage cursors\n",
+                                             prv_shell_log_storage_cursors,
+                                             1,
                                              0),
+                               OVYL_LOG_STORAGE_BACKEND_SHELL_CMDS
+                               OVYL_LOG_STORAGE_LEVEL_SHELL_CMDS,
                                SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(log_storage, &log_storage_cmds, "Log storage commands", NULL);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_backend.h
+ * @brief Storage backend interface behind the ovyl_log_storage_* API.
+ *
+ * log_storage.c implements the public API once: argument checks, the read
+ * head, named cursors, the export loop with its filter and sink flow control,
+ * statistics and the shell. Everything that depends on how logs sit in flash
+ * goes through the operations below. Exactly one backend is built, selected
+ * by the OVYL_LOG_STORAGE_BACKEND choice; it also defines the reader position
+ * type.
+ *
+ * The front end calls every operation with the mutex it hands to init() held,
+ * except init(), append(), append_record(), flush(), panic() and
+ * wear_level(). Logging reaches those from any context, fault handlers
+ * included, so backends take the mutex themselves where they can block. Work
+ * items and threads of a backend take the same mutex.
+ */
+
+#ifndef OVYL_LOG_STORAGE_BACKEND_H
+#define OVYL_LOG_STORAGE_BACKEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB
+#include <zephyr/fs/fcb.h>
+#endif
+
+#include <ovyl/log_storage.h>
+
+#include "log_storage_export.h"
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB)
+/** @brief Reader position: the FCB entry being read and the bytes of it already returned. */
+typedef struct {
+    struct fcb_entry head;
+    size_t read_bytes;
+} ovyl_log_storage_read_ctx_t;
+#elif defined(CONFIG_OVYL_LOG_STORAGE_BACKEND_LITTLEFS)
+/** @brief Reader position: a byte offset within a numbered segment file. */
+typedef struct {
+    uint32_t segment;
+    uint32_t offset;
+    bool started; /**< False until the first read places the reader at the oldest segment. */
+} ovyl_log_storage_read_ctx_t;
+#endif
+
+/**
+ * @brief Operations of a storage backend.
+ *
+ * A zeroed ovyl_log_storage_read_ctx_t starts at the oldest stored data.
+ * Optional operations are NULL when the backend lacks the feature; the
+ * front end then returns -ENOTSUP.
+ */
+typedef struct ovyl_log_storage_backend_api {
+    /** Unit in which readers lose data to rotation ("sector", "segment"). */
+    const char *unit;
+    /** Mount the storage. @p lock is the front end's mutex, already initialized. */
+    int (*init)(struct k_mutex *lock);
+    /** Store @p len bytes of formatted log output. */
+    int (*append)(const void *buf, size_t len);
+    /** Optional: encode @p hdr into the first bytes of @p record and store the record. */
+    int (*append_record)(const ovyl_log_storage_record_hdr_t *hdr, uint8_t *record, size_t payload_len);
+    /** Commit buffered appends to flash. */
+    int (*flush)(void);
+    /** Enter panic mode and commit everything; must not wait on the mutex. */
+    int (*panic)(void);
+    /** Make every append so far visible to readers. */
+    int (*sync)(void);
+    /**
+     * Copy the next bytes for @p ctx, at most to the end of one stored unit
+     * of data. @p bounded readers stop at the snapshot end.
+     *
+     * @retval -ENOENT No more data.
+     */
+    int (*read)(ovyl_log_storage_read_ctx_t *ctx, bool bounded, void *dst, size_t size, size_t *out_size);
+    /**
+     * Fill @p dst across stored units. With OVYL_LOG_STORAGE_BULK_ENTRY_HDR
+     * in @p flags each entry is prefixed with its length.
+     *
+     * @retval -ENOENT No more data; nothing was copied.
+     */
+    int (*read_bulk)(ovyl_log_storage_read_ctx_t *ctx,
+                     bool bounded,
+                     uint8_t *dst,
+                     size_t size,
+                     uint32_t flags,
+                     size_t *out_size);
+    /** Unit and offset @p ctx reads at; -ENOENT when it has not started yet. */
+    int (*position)(const ovyl_log_storage_read_ctx_t *ctx, uint32_t *unit, uint32_t *offset);
+    /** Capture the end of the stored data and keep unread data from rotating out. */
+    void (*snapshot_begin)(void);
+    /** Release the snapshot. */
+    void (*snapshot_end)(void);
+    /** The read head went back to the oldest data; keep it from rotating out. */
+    void (*snapshot_rewind)(void);
+    /**
+     * Optional: apply the time and boot filters of @p f->filter to the
+     * export reader @p ctx. Without it, those filters are not supported.
+     */
+    int (*export_begin)(ovyl_log_storage_read_ctx_t *ctx, ovyl_log_storage_export_filter_t *f);
+    /** Optional: read the next export chunk, replacing a bounded read_bulk(). */
+    int (*export_read)(ovyl_log_storage_read_ctx_t *ctx, uint8_t *dst, size_t size, uint32_t flags, size_t *out_size);
+    /** Erase every stored log. The front end restarts all readers afterwards. */
+    int (*clear)(void);
+    /** Optional: place @p ctx at the first data stored at or after the given time. */
+    int (*seek_time)(ovyl_log_storage_read_ctx_t *ctx, uint16_t boot_id, uint64_t uptime_ms);
+    /** Optional: boot id of the current boot. */
+    uint16_t (*boot_id)(void);
+    /** Optional: incremental upload, see ovyl_log_storage_upload_fetch(). */
+    int (*upload_fetch)(void *dst, size_t size, size_t *out_size);
+    /** Optional: see ovyl_log_storage_upload_ack(). */
+    int (*upload_ack)(void);
+    /** Optional: see ovyl_log_storage_upload_rewind(). */
+    int (*upload_rewind)(void);
+    /** Optional: see ovyl_log_storage_upload_reset(). */
+    int (*upload_reset)(void);
+    /** Optional: see ovyl_log_storage_set_erase_ahead(). */
+    int (*set_erase_ahead)(bool enable);
+    /** Optional: see ovyl_log_storage_get_wear(). */
+    int (*get_wear)(ovyl_log_storage_wear_status_t *status);
+    /** Optional: see ovyl_log_storage_wear_level(). */
+    uint8_t (*wear_level)(void);
+    /** Fill the counters the backend keeps; the front end adds the export counters. */
+    void (*get_stats)(ovyl_log_storage_stats_t *stats);
+    /** Zero the counters the backend keeps. */
+    void (*reset_stats)(void);
+#ifdef CONFIG_SHELL
+    /** Print the backend's part of "log_storage stats". */
+    void (*shell_stats)(const struct shell *sh, const ovyl_log_storage_stats_t *stats);
+#endif
+} ovyl_log_storage_backend_api_t;
+
+/**
+ * @brief Restart readers whose unread data a backend is about to lose.
+ *
+ * Asks @p lost about the read head and every open cursor; a reader it
+ * returns true for restarts at the oldest data, and a cursor counts one lost
+ * unit. With @p lost NULL every reader, the export reader included, restarts
+ * without counting a loss. Mutex must be held.
+ */
+void ovyl_log_storage_readers_drop(bool (*lost)(const ovyl_log_storage_read_ctx_t *ctx, void *arg), void *arg);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB
+/** @brief Flash circular buffer on the logging_storage partition. */
+extern const ovyl_log_storage_backend_api_t ovyl_log_storage_backend_fcb;
+
+#ifdef CONFIG_SHELL
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/** @brief Shell handler that prints the per-sector time index. */
+int ovyl_log_storage_fcb_shell_index(const struct shell *sh, size_t argc, char **argv);
+
+#define OVYL_LOG_STORAGE_FCB_INDEX_SHELL_CMDS                                                      \
+    SHELL_CMD_ARG(index,                                                                           \
+                  NULL,                                                                            \
+                  "Print the per-sector time index.\n"                                             \
+                  "usage:\n"                                                                       \
+                  "$ log_storage index\n",                                                         \
+                  ovyl_log_storage_fcb_shell_index,                                                \
+                  1,                                                                               \
+                  0),
+#else
+#define OVYL_LOG_STORAGE_FCB_INDEX_SHELL_CMDS
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+/** @brief Shell handler that prints (or resets) the upload watermark. */
+int ovyl_log_storage_fcb_shell_watermark(const struct shell *sh, size_t argc, char **argv);
+
+#define OVYL_LOG_STORAGE_FCB_WATERMARK_SHELL_CMDS                                                  \
+    SHELL_CMD_ARG(watermark,                                                                       \
+                  NULL,                                                                            \
+                  "Print or reset the upload watermark.\n"                                         \
+                  "usage:\n"                                                                       \
+                  "$ log_storage watermark [reset]\n",                                             \
+                  ovyl_log_storage_fcb_shell_watermark,                                            \
+                  1,                                                                               \
+                  1),
+#else
+#define OVYL_LOG_STORAGE_FCB_WATERMARK_SHELL_CMDS
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+/** @brief Shell handler that shows or toggles background sector pre-erase. */
+int ovyl_log_storage_fcb_shell_erase_ahead(const struct shell *sh, size_t argc, char **argv);
+
+#define OVYL_LOG_STORAGE_FCB_ERASE_AHEAD_SHELL_CMDS                                                \
+    SHELL_CMD_ARG(erase_ahead,                                                                     \
+                  NULL,                                                                            \
+                  "Show or toggle background sector pre-erase.\n"                                  \
+                  "usage:\n"                                                                       \
+                  "$ log_storage erase_ahead [on|off]\n",                                          \
+                  ovyl_log_storage_fcb_shell_erase_ahead,                                          \
+                  1,                                                                               \
+                  1),
+#else
+#define OVYL_LOG_STORAGE_FCB_ERASE_AHEAD_SHELL_CMDS
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+/** @brief Shell handler that prints wear counters and the write-budget governor state. */
+int ovyl_log_storage_fcb_shell_wear(const struct shell *sh, size_t argc, char **argv);
+
+#define OVYL_LOG_STORAGE_FCB_WEAR_SHELL_CMDS                                                       \
+    SHELL_CMD_ARG(wear,                                                                            \
+                  NULL,                                                                            \
+                  "Print flash wear counters and the write-budget\n"                               \
+                  "governor state.\n"                                                              \
+                  "usage:\n"                                                                       \
+                  "$ log_storage wear\n",                                                          \
+                  ovyl_log_storage_fcb_shell_wear,                                                 \
+                  1,                                                                               \
+                  0),
+#else
+#define OVYL_LOG_STORAGE_FCB_WEAR_SHELL_CMDS
+#endif
+
+/** @brief Backend entries of the log_storage shell command, each followed by a comma. */
+#define OVYL_LOG_STORAGE_BACKEND_SHELL_CMDS                                                        \
+    OVYL_LOG_STORAGE_FCB_INDEX_SHELL_CMDS                                                          \
+    OVYL_LOG_STORAGE_FCB_WATERMARK_SHELL_CMDS                                                      \
+    OVYL_LOG_STORAGE_FCB_ERASE_AHEAD_SHELL_CMDS                                                    \
+    OVYL_LOG_STORAGE_FCB_WEAR_SHELL_CMDS
+#endif /* CONFIG_SHELL */
+#endif /* CONFIG_OVYL_LOG_STORAGE_BACKEND_FCB */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_BACKEND_LITTLEFS
+/** @brief LittleFS directory holding one append-only file per boot. */
+extern const ovyl_log_storage_backend_api_t ovyl_log_storage_backend_littlefs;
+
+#define OVYL_LOG_STORAGE_BACKEND_SHELL_CMDS
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVYL_LOG_STORAGE_BACKEND_H */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_cfg.h
+ * @brief Build-time checks of the Ovyl Config entries the module persists.
+ *
+ * The application declares these entries in its CONFIG_OVYL_CONFIG_APP_DEF_PATH
+ * file. Reading that file again here turns every entry into a typedef, so an
+ * entry that is missing, or declared with a type of the wrong size, fails the
+ * build instead of making ovyl_config_mgr_get_value() fail at runtime.
+ */
+
+#ifndef OVYL_LOG_STORAGE_CFG_H
+#define OVYL_LOG_STORAGE_CFG_H
+
+#include <zephyr/toolchain.h>
+
+#include <ovyl/log_storage.h>
+#include <ovyl/configs.h>
+
+#ifdef CONFIG_OVYL_CONFIG_USE_CUSTOM_TYPES
+#include CONFIG_OVYL_CONFIG_TYPES_DEF_PATH
+#endif
+
+#define CFG_DEFINE(key, type, default_val, rst) typedef type ovyl_log_storage_cfg_##key##_t;
+#include CONFIG_OVYL_CONFIG_APP_DEF_PATH
+#undef CFG_DEFINE
+
+/**
+ * @brief Fail the build unless the application declared @p key with a type the size of @p type.
+ *
+ * A key that is not declared at all fails earlier, on the unknown
+ * ovyl_log_storage_cfg_<key>_t type.
+ */
+#define OVYL_LOG_STORAGE_CFG_CHECK(key, type)                                                      \
+    BUILD_ASSERT(sizeof(ovyl_log_storage_cfg_##key##_t) == sizeof(type),                           \
+                 "Declare CFG_DEFINE(" #key ", " #type ", ...) in the app config definition file")
+
+#endif /* OVYL_LOG_STORAGE_CFG_H */
@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_export.c
+ * @brief Export helpers shared by the FCB and stream front ends.
+ *
+ * Record header decoding, the export record filter and sink flow control.
+ * They work on the byte stream an export reads back, so they need nothing
+ * from the storage layout.
+ */
+
+#include "log_storage_export.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_internal.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+#include <zephyr/logging/log_output_dict.h>
+#endif
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "log_storage_level.h"
+
+#define LOG_STORAGE_EXPORT_BACKOFF_MS (10U)
+#define LOG_STORAGE_EXPORT_STALL_MS   (5000U)
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+BUILD_ASSERT(sizeof(struct log_dict_output_normal_msg_hdr_t) <= OVYL_LOG_STORAGE_FILTER_HDR_MAX,
+             "Dictionary record header must fit the filter buffer");
+#endif
+
+int ovyl_log_storage_record_hdr_decode(const uint8_t *buf, ovyl_log_storage_record_hdr_t *hdr)
+{
+    if ((buf == NULL) || (hdr == NULL) || (buf[0] != OVYL_LOG_STORAGE_RECORD_SYNC)) {
+        return -EINVAL;
+    }
+
+    /* The sync byte alone matches one byte in 256 of free text; the other fields narrow it down. */
+    if (((buf[1] & 0x07U) > LOG_LEVEL_DBG) || (((buf[1] >> 3) & ~OVYL_LOG_STORAGE_RECORD_FLAGS_KNOWN) != 0U) ||
+        (sys_get_le16(&buf[6]) > CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE)) {
+        return -EINVAL;
+    }
+
+    hdr->level = buf[1] & 0x07U;
+    hdr->flags = buf[1] >> 3;
+    hdr->source_id = sys_get_le16(&buf[2]);
+    hdr->boot_id = sys_get_le16(&buf[4]);
+    hdr->len = sys_get_le16(&buf[6]);
+    hdr->seq = sys_get_le32(&buf[8]);
+    hdr->timestamp = sys_get_le64(&buf[12]);
+
+    return 0;
+}
+
+/** @brief Check a record's level and source id against the export filter. */
+static bool prv_filter_match(const ovyl_log_storage_filter_t *filter, uint8_t level, int32_t source_id)
+{
+    if (((filter->flags & OVYL_LOG_STORAGE_FILTER_LEVEL) != 0U) && (level > filter->max_level)) {
+        return false;
+    }
+
+    if ((filter->flags & OVYL_LOG_STORAGE_FILTER_SOURCE) == 0U) {
+        return true;
+    }
+
+    for (size_t i = 0; i < filter->source_cnt; i++) {
+        if ((int32_t)filter->sources[i] == source_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_RECORD_HDR) || defined(CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY)
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+/** @brief Size of the record header starting with @p first; records share one fixed header. */
+static size_t prv_filter_hdr_size(uint8_t first)
+{
+    ARG_UNUSED(first);
+
+    return OVYL_LOG_STORAGE_RECORD_HDR_SIZE;
+}
+
+/**
+ * @brief Match a complete structured record header and size the record body.
+ *
+ * @retval false The bytes are not a record header (data from before record headers).
+ */
+static bool prv_filter_decide(ovyl_log_storage_export_filter_t *f)
+{
+    ovyl_log_storage_record_hdr_t hdr;
+
+    if (ovyl_log_storage_record_hdr_decode(f->hdr, &hdr) < 0) {
+        return false;
+    }
+
+    f->body_left = hdr.len;
+
+    if ((hdr.flags & OVYL_LOG_STORAGE_RECORD_CONT) != 0U) {
+        return true;
+    }
+
+    f->keep = (hdr.source_id == OVYL_LOG_STORAGE_RECORD_NO_SOURCE) ||
+              prv_filter_match(f->filter, hdr.level, hdr.source_id);
+    return true;
+}
+#else
+/** @brief Size of the dictionary record header starting with @p type. */
+static size_t prv_filter_hdr_size(uint8_t type)
+{
+    return (type == MSG_DROPPED_MSG) ? sizeof(struct log_dict_output_dropped_msg_t)
+                                     : sizeof(struct log_dict_output_normal_msg_hdr_t);
+}
+
+/**
+ * @brief Match a complete dictionary record header and size the record body.
+ *
+ * @retval true Always; dictionary records carry no sync byte to check.
+ */
+static bool prv_filter_decide(ovyl_log_storage_export_filter_t *f)
+{
+    struct log_dict_output_normal_msg_hdr_t hdr;
+
+    if (f->hdr[0] == MSG_DROPPED_MSG) {
+        f->keep = true;
+        f->body_left = 0U;
+        return true;
+    }
+
+    memcpy(&hdr, f->hdr, sizeof(hdr));
+    f->keep = prv_filter_match(f->filter, hdr.level, (int32_t)hdr.source);
+    f->body_left = (size_t)hdr.package_len + hdr.data_len;
+    return true;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_RECORD_HDR */
+
+/**
+ * @brief Filter a chunk of binary records from @p in into @p out.
+ *
+ * @p out may alias the buffer @p in lives in as long as it starts at least
+ * OVYL_LOG_STORAGE_FILTER_HDR_MAX bytes earlier.
+ *
+ * @return Bytes written to @p out.
+ */
+size_t ovyl_log_storage_filter_records(ovyl_log_storage_export_filter_t *f, uint8_t *out, const uint8_t *in, size_t len)
+{
+    size_t n = 0U;
+    size_t i = 0U;
+
+    while (i < len) {
+        if (f->body_left > 0U) {
+            size_t run = MIN(f->body_left, len - i);
+
+            if (f->keep) {
+                memmove(&out[n], &in[i], run);
+                n += run;
+            }
+
+            f->body_left -= run;
+            i += run;
+            continue;
+        }
+
+        f->hdr[f->hdr_len++] = in[i++];
+
+        if (f->hdr_len < prv_filter_hdr_size(f->hdr[0])) {
+            continue;
+        }
+
+        if (!prv_filter_decide(f)) {
+            /* Not at a record boundary: drop one byte and resynchronize, as the merge does. */
+            f->hdr_len--;
+            memmove(f->hdr, &f->hdr[1], f->hdr_len);
+            continue;
+        }
+
+        if (f->keep) {
+            memcpy(&out[n], f->hdr, f->hdr_len);
+            n += f->hdr_len;
+        }
+
+        f->hdr_len = 0U;
+    }
+
+    return n;
+}
+
+/** @brief Flush a record prefix held at the end of an export; a partial binary header is dropped. */
+size_t ovyl_log_storage_filter_finish(ovyl_log_storage_export_filter_t *f, uint8_t *out)
+{
+    ARG_UNUSED(out);
+
+    f->hdr_len = 0U;
+    return 0U;
+}
+#else
+/** @brief Look up the local domain source id of a module name. */
+static int32_t prv_filter_source_id(const char *name, size_t len)
+{
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+
+    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+        const char *source_name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id);
+
+        if ((source_name != NULL) && (strlen(source_name) == len) && (memcmp(source_name, name, len) == 0)) {
+            return (int32_t)source_id;
+        }
+    }
+
+    return -1;
+}
+
+/** @brief Check whether the held line prefix is long enough to match. */
+static bool prv_filter_hdr_ready(const ovyl_log_storage_export_filter_t *f, uint8_t c)
+{
+    /* Only "[timestamp] <lvl> module:" lines start a record. */
+    return (f->hdr[0] != '[') || (c == '\n') || (f->hdr_len == sizeof(f->hdr)) ||
+           ((c == ':') && (memchr(f->hdr, '>', f->hdr_len) != NULL));
+}
+
+/** @brief Match a held text line prefix; continuation lines follow the previous record. */
+static void prv_filter_decide(ovyl_log_storage_export_filter_t *f)
+{
+    const char *hdr = (const char *)f->hdr;
+    const char *end = hdr + f->hdr_len;
+    char level_name[4];
+
+    if (hdr[0] == '-') {
+        /* "--- N messages dropped ---" */
+        f->keep = true;
+        return;
+    }
+
+    if (hdr[0] != '[') {
+        return;
+    }
+
+    const char *lvl = memchr(hdr, '<', f->hdr_len);
+
+    if ((lvl == NULL) || ((end - lvl) < 6) || (lvl[4] != '>')) {
+        f->keep = true;
+        return;
+    }
+
+    memcpy(level_name, &lvl[1], 3);
+    level_name[3] = '\0';
+
+    uint8_t level = LOG_LEVEL_NONE;
+    const char *module = &lvl[6];
+    const char *colon = memchr(module, ':', (size_t)(end - module));
+    int32_t source_id = (colon != NULL) ? prv_filter_source_id(module, (size_t)(colon - module)) : -1;
+
+    (void)ovyl_log_storage_level_parse(level_name, &level);
+    f->keep = prv_filter_match(f->filter, level, source_id);
+}
+
+/**
+ * @brief Filter a chunk of text log lines from @p in into @p out.
+ *
+ * @p out may alias the buffer @p in lives in as long as it starts at least
+ * OVYL_LOG_STORAGE_FILTER_HDR_MAX bytes earlier.
+ *
+ * @return Bytes written to @p out.
+ */
+size_t ovyl_log_storage_filter_records(ovyl_log_storage_export_filter_t *f, uint8_t *out, const uint8_t *in, size_t len)
+{
+    size_t n = 0U;
+    size_t i = 0U;
+
+    while (i < len) {
+        if (f->in_body) {
+            const uint8_t *nl = memchr(&in[i], '\n', len - i);
+            size_t run = (nl != NULL) ? (size_t)(nl - &in[i]) + 1U : (len - i);
+
+            if (f->keep) {
+                memmove(&out[n], &in[i], run);
+                n += run;
+            }
+
+            f->in_body = (nl == NULL);
+            i += run;
+            continue;
+        }
+
+        uint8_t c = in[i++];
+
+        f->hdr[f->hdr_len++] = c;
+
+        if (!prv_filter_hdr_ready(f, c)) {
+            continue;
+        }
+
+        prv_filter_decide(f);
+
+        if (f->keep) {
+            memcpy(&out[n], f->hdr, f->hdr_len);
+            n += f->hdr_len;
+        }
+
+        f->hdr_len = 0U;
+        f->in_body = (c != '\n');
+    }
+
+    return n;
+}
+
+/** @brief Flush a line prefix still held when the export reaches its end. */
+size_t ovyl_log_storage_filter_finish(ovyl_log_storage_export_filter_t *f, uint8_t *out)
+{
+    size_t n = 0U;
+
+    if (f->hdr_len > 0U) {
+        prv_filter_decide(f);
+
+        if (f->keep) {
+            memcpy(out, f->hdr, f->hdr_len);
+            n = f->hdr_len;
+        }
+    }
+
+    f->hdr_len = 0U;
+    return n;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_RECORD_HDR || CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY */
+
+void ovyl_log_storage_filter_begin(ovyl_log_storage_export_filter_t *f, const ovyl_log_storage_filter_t *filter)
+{
+    memset(f, 0, sizeof(*f));
+    f->filter = filter;
+    f->keep = true;
+}
+
+int ovyl_log_storage_export_credit(const ovyl_log_storage_sink_t *sink, size_t min, size_t *credit)
+{
+    uint32_t stalled_ms = 0U;
+
+    while (true) {
+        size_t avail = CONFIG_OVYL_LOG_STORAGE_EXPORT_CHUNK_SIZE;
+
+        if (sink->api->credit != NULL) {
+            avail = MIN(avail, sink->api->credit(sink->ctx));
+        }
+
+        if (avail > min) {
+            *credit = avail;
+            return 0;
+        }
+
+        /* Back-pressure: the transport has no room; wait without holding the lock. */
+        if (stalled_ms >= LOG_STORAGE_EXPORT_STALL_MS) {
+            return -ETIMEDOUT;
+        }
+
+        k_sleep(K_MSEC(LOG_STORAGE_EXPORT_BACKOFF_MS));
+        stalled_ms += LOG_STORAGE_EXPORT_BACKOFF_MS;
+    }
+}
+
+int ovyl_log_storage_export_write(const ovyl_log_storage_sink_t *sink, const uint8_t *data, size_t len)
+{
+    while (len > 0U) {
+        size_t credit;
+        int ret = ovyl_log_storage_export_credit(sink, 0U, &credit);
+
+        if (ret < 0) {
+            return ret;
+        }
+
+        credit = MIN(credit, len);
+
+        ret = sink->api->write(sink->ctx, data, credit);
+        if (ret < 0) {
+            return ret;
+        }
+
+        data += credit;
+        len -= credit;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_export.h
+ * @brief Export helpers shared by the log storage front ends.
+ */
+
+#ifndef OVYL_LOG_STORAGE_EXPORT_H
+#define OVYL_LOG_STORAGE_EXPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ovyl/log_storage.h>
+
+/** @brief Longest record prefix held back until an export filter can match the record. */
+#define OVYL_LOG_STORAGE_FILTER_HDR_MAX (64U)
+
+/** @brief Export filter flags matched against the records themselves. */
+#define OVYL_LOG_STORAGE_FILTER_RECORD_FLAGS (OVYL_LOG_STORAGE_FILTER_LEVEL | OVYL_LOG_STORAGE_FILTER_SOURCE)
+
+/** @brief Record flags a valid header may carry; any other bit marks a false sync match. */
+#define OVYL_LOG_STORAGE_RECORD_FLAGS_KNOWN (OVYL_LOG_STORAGE_RECORD_CONT)
+
+/**
+ * @brief Streaming state of the export record filter.
+ *
+ * The start of each record is held in @c hdr until it is long enough to
+ * match; the rest of the record is then copied or dropped as it streams by.
+ */
+typedef struct {
+    const ovyl_log_storage_filter_t *filter;
+    uint8_t hdr[OVYL_LOG_STORAGE_FILTER_HDR_MAX];
+    size_t hdr_len;
+    size_t body_left; /* Dictionary record bytes following the header. */
+    bool in_body;     /* Text line whose fate is already decided. */
+    bool keep;
+    uint16_t boot; /* Boot id of the entry being read, from the last marker seen. */
+    bool boot_known;
+} ovyl_log_storage_export_filter_t;
+
+/** @brief Reset @p f for a new export matching @p filter. */
+void ovyl_log_storage_filter_begin(ovyl_log_storage_export_filter_t *f, const ovyl_log_storage_filter_t *filter);
+
+/**
+ * @brief Filter a chunk of exported records from @p in into @p out.
+ *
+ * Records may span chunks; a partial record prefix is held in @p f until the
+ * next call. @p out may alias the buffer @p in lives in as long as it starts
+ * at least OVYL_LOG_STORAGE_FILTER_HDR_MAX bytes earlier.
+ *
+ * @return Bytes written to @p out.
+ */
+size_t ovyl_log_storage_filter_records(ovyl_log_storage_export_filter_t *f, uint8_t *out, const uint8_t *in, size_t len);
+
+/**
+ * @brief Release a record prefix still held when the export reaches its end.
+ *
+ * @return Bytes written to @p out, at most OVYL_LOG_STORAGE_FILTER_HDR_MAX.
+ */
+size_t ovyl_log_storage_filter_finish(ovyl_log_storage_export_filter_t *f, uint8_t *out);
+
+/**
+ * @brief Wait until the sink can take more than @p min bytes.
+ *
+ * A credit of @p min bytes or less counts as none, so a fetch that needs room
+ * for a prefix never runs with a buffer too small to make progress. Must be
+ * called without the storage mutex held.
+ *
+ * @retval 0 @p credit holds the bytes the sink accepts, capped at one chunk.
+ * @retval -ETIMEDOUT The sink granted no usable credit for five seconds.
+ */
+int ovyl_log_storage_export_credit(const ovyl_log_storage_sink_t *sink, size_t min, size_t *credit);
+
+/**
+ * @brief Hand @p len bytes to the sink in pieces it has credit for.
+ *
+ * @retval 0 Success.
+ * @retval -ETIMEDOUT The sink stalled, see ovyl_log_storage_export_credit().
+ * @retval Negative errno value returned by the sink.
+ */
+int ovyl_log_storage_export_write(const ovyl_log_storage_sink_t *sink, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVYL_LOG_STORAGE_EXPORT_H */
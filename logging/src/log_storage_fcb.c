@@ -0,0 +1,3861 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_fcb.c
+ * @brief Flash circular buffer log storage backend.
+ *
+ * Stores logs as FCB entries on the logging_storage fixed partition. The
+ * optional storage features (staging, async writer, time index, priority
+ * lane, ...) all live here; log_storage.c reaches them through
+ * log_storage_backend.h.
+ */
+
+#include <ovyl/log_storage.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_internal.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/fs/fcb.h>
+
+
+#include <ovyl/config_mgr.h>
+#include <ovyl/configs.h>
+
+#include "log_storage_backend.h"
+#include "log_storage_cfg.h"
+#include "log_storage_export.h"
+#include "log_storage_level.h"
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+#include "log_compress.h"
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+#include "log_storage_ring.h"
+#endif
+
+LOG_MODULE_DECLARE(ovyl_log_storage, CONFIG_OVYL_LOG_STORAGE_LOG_LEVEL);
+
+#define LOG_STORAGE_FLASH_LABEL logging_storage
+#define LOG_STORAGE_FLASH_AREA_ID FLASH_AREA_ID(LOG_STORAGE_FLASH_LABEL)
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+/* Compressed logs get their own sector magic, so an entry's format never has to be guessed from its bytes. */
+#define LOG_STORAGE_FCB_MAGIC (0x1EE71C05U)
+#else
+#define LOG_STORAGE_FCB_MAGIC (0x1EE71065U)
+#endif
+#define LOG_STORAGE_MIN_SECTOR_SIZE ((size_t)CONFIG_OVYL_LOG_STORAGE_MIN_SECTOR_SIZE)
+/* Spreads the merged sector size over the magic's bits (golden-ratio multiplier). */
+#define LOG_STORAGE_LAYOUT_MIX (0x9E3779B1U)
+/* One entry per minimum-size sector by default keeps 4 KB pages one per sector, the layout of earlier releases. */
+#define LOG_STORAGE_NUM_SECTORS OVYL_LOG_STORAGE_NUM_SECTORS
+#define LOG_STORAGE_MUTEX_TIMEOUT_MS (200U)
+
+/* Read position of an entry a filtered export decided to skip. */
+#define LOG_STORAGE_ENTRY_SKIPPED SIZE_MAX
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/* Time marker prefixed to the first entry of each sector and of each boot. */
+#define LOG_STORAGE_MARKER_MAGIC (0x54494DA5U)
+#define LOG_STORAGE_MARKER_SIZE  (16U)
+#define LOG_STORAGE_TIME_KEY(boot_id, uptime_ms)                                                   \
+    (((uint64_t)(boot_id) << 48) | ((uint64_t)(uptime_ms) & BIT64_MASK(48)))
+#define LOG_STORAGE_TIME_KEY_NONE UINT64_MAX
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+#define LOG_STORAGE_LANE_MAGIC (0x1EE7E220U)
+#define LOG_STORAGE_LANE_SECTORS CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE_SECTORS
+/* Indexes into the export merge state. */
+#define LOG_STORAGE_LANE_MAIN (0)
+#define LOG_STORAGE_LANE_PRIO (1)
+#define LOG_STORAGE_RECORD_KEY(hdr) (((uint64_t)(hdr).boot_id << 32) | (hdr).seq)
+
+BUILD_ASSERT(LOG_STORAGE_NUM_SECTORS >= (LOG_STORAGE_LANE_SECTORS + 2U),
+             "Sector table too small for the priority lane and the main log");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PAGE_ALIGN
+#define LOG_STORAGE_PROGRAM_PAGE_SIZE CONFIG_OVYL_LOG_STORAGE_PROGRAM_PAGE_SIZE
+/* Entry lengths below this take a one-byte FCB length prefix. */
+#define LOG_STORAGE_FCB_SHORT_LEN_LIMIT (0x80U)
+
+BUILD_ASSERT(CONFIG_OVYL_LOG_STORAGE_STAGING_SIZE >= LOG_STORAGE_PROGRAM_PAGE_SIZE,
+             "Staging buffer must hold at least one program page");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+#define LOG_STORAGE_PANIC_SECTORS CONFIG_OVYL_LOG_STORAGE_PANIC_REGION_SECTORS
+#define LOG_STORAGE_PANIC_CHUNK_MAGIC (0xC7A5U)
+/* Chunk holding the time marker of the boot that panicked, written ahead of its first data chunk. */
+#define LOG_STORAGE_PANIC_BOOT_MAGIC (0xC7B0U)
+#define LOG_STORAGE_PANIC_CHUNK_HDR_SIZE (4U)
+#define LOG_STORAGE_PANIC_CHUNK_SIZE (128U)
+/* Largest flash write block the panic region supports. */
+#define LOG_STORAGE_PANIC_ALIGN_MAX (32U)
+
+BUILD_ASSERT(LOG_STORAGE_NUM_SECTORS >= (LOG_STORAGE_PANIC_SECTORS + 2U),
+             "Sector table too small for the panic region and the main log");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+#define LOG_STORAGE_COMPRESS_MAX_INPUT CONFIG_OVYL_LOG_STORAGE_STAGING_SIZE
+#else
+#define LOG_STORAGE_COMPRESS_MAX_INPUT CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE
+#endif
+/* Every entry in a compressed log starts with a method byte and the little-endian raw length. */
+#define LOG_STORAGE_ENTRY_HDR_SIZE (3U)
+#define LOG_STORAGE_ENTRY_RAW (0xC0U)
+#define LOG_STORAGE_ENTRY_LZSS (0xC1U)
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+#define LOG_STORAGE_WRITER_PRIORITY K_PRIO_PREEMPT(CONFIG_OVYL_LOG_STORAGE_ASYNC_THREAD_PRIORITY)
+#define LOG_STORAGE_WRITER_STACK_SIZE CONFIG_OVYL_LOG_STORAGE_ASYNC_THREAD_STACK_SIZE
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+#define LOG_STORAGE_WEAR_MAGIC (0x4C535745U)
+#define LOG_STORAGE_WEAR_CYCLES ((uint32_t)CONFIG_OVYL_LOG_STORAGE_WEAR_CYCLES)
+/* Powered-on hours the log has to last, counting 365.25 days per year. */
+#define LOG_STORAGE_WEAR_LIFETIME_HOURS ((uint32_t)CONFIG_OVYL_LOG_STORAGE_WEAR_LIFETIME_YEARS * 8766U)
+#define LOG_STORAGE_WEAR_HOUR_MS (3600000LL)
+#define LOG_STORAGE_WEAR_MINUTE_MS (60000LL)
+#define LOG_STORAGE_WEAR_RETRY_MS (1000U)
+
+BUILD_ASSERT(ARRAY_SIZE(((ovyl_log_storage_wear_t *)0)->erases) == LOG_STORAGE_NUM_SECTORS,
+             "Wear record must hold an erase count for every sector table entry");
+OVYL_LOG_STORAGE_CFG_CHECK(CFG_LOG_STORAGE_WEAR, ovyl_log_storage_wear_t);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+/** @brief RAM staging buffer that coalesces appends into a single FCB entry. */
+typedef struct {
+    uint8_t buf[CONFIG_OVYL_LOG_STORAGE_STAGING_SIZE];
+    size_t used;
+    uint32_t appends;
+    uint32_t entry_overhead;
+    struct k_work_delayable flush_work;
+} ovyl_log_storage_staging_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+/**
+ * @brief Incremental upload state.
+ *
+ * @c acked mirrors the persisted watermark (last entry the host confirmed) and
+ * @c delivered is the last entry fully returned by the upload fetch. When
+ * @c resume is set, @c ctx.head is an already consumed entry to step past.
+ */
+typedef struct {
+    ovyl_log_storage_read_ctx_t ctx;
+    struct fcb_entry delivered;
+    struct fcb_entry acked;
+    bool resume;
+} ovyl_log_storage_upload_t;
+
+OVYL_LOG_STORAGE_CFG_CHECK(CFG_LOG_STORAGE_WATERMARK, ovyl_log_storage_position_t);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+/**
+ * @brief Start of the visible log after a logical clear.
+ *
+ * Entries before @c elem_off in @c sector, and all older sectors, are hidden
+ * from readers until rotation erases them. @c sector is NULL when nothing is
+ * hidden.
+ */
+typedef struct {
+    struct flash_sector *sector;
+    uint32_t elem_off;
+} ovyl_log_storage_floor_t;
+
+OVYL_LOG_STORAGE_CFG_CHECK(CFG_LOG_STORAGE_CLEAR_FLOOR, ovyl_log_storage_position_t);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/**
+ * @brief Per-sector time index rebuilt from the on-flash markers at boot.
+ *
+ * Keys combine boot id and uptime so they order across reboots. A sector
+ * covers the time from its own key up to the key of the following sector.
+ */
+typedef struct {
+    uint64_t first_key[LOG_STORAGE_NUM_SECTORS];
+    uint64_t last_key; /* Most recent append to the active sector this boot. */
+    uint64_t recover_key; /* Key markers carry while a crashed boot's panic logs are copied in. */
+    uint16_t boot_id;
+    bool boot_marked;
+    struct fcb_entry marker_loc; /* Last entry checked for a marker prefix. */
+    uint8_t marker_base;
+} ovyl_log_storage_time_index_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+/** @brief Window of flash contents kept in RAM to serve consecutive small reads. */
+typedef struct {
+    uint8_t buf[CONFIG_OVYL_LOG_STORAGE_READ_AHEAD_SIZE];
+    off_t off; /* Flash area offset of buf[0]. */
+    size_t len; /* Valid bytes in buf; 0 when empty. */
+} ovyl_log_storage_read_ahead_t;
+#endif
+
+/**
+ * @brief Export snapshot bounds.
+ *
+ * @c end is the FCB write position when the export started; entries at or
+ * beyond it are left for the next export. @c pin is the sector holding the
+ * export cursor, which rotation must not erase while the snapshot is active.
+ */
+typedef struct {
+    bool active;
+    struct fcb_entry end;
+    struct flash_sector *pin;
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    uint64_t until; /* Stop at the first sector indexed after this time key. */
+#endif
+} ovyl_log_storage_snapshot_t;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+/**
+ * @brief High-severity lane: a second FCB on the last sectors of the partition.
+ *
+ * Every entry holds exactly one record. During an export @c end is the lane's
+ * write position when the export started and @c pin the sector being read,
+ * which lane rotation must not erase.
+ */
+typedef struct {
+    struct fcb fcb;
+    struct fcb_entry end;
+    struct flash_sector *pin;
+    bool ready;
+} ovyl_log_storage_lane_t;
+
+/**
+ * @brief Export merge state.
+ *
+ * Holds the next record header of each lane; @c cur is the lane whose record
+ * is being copied out, or -1 between records.
+ */
+typedef struct {
+    uint8_t raw[2][OVYL_LOG_STORAGE_RECORD_HDR_SIZE];
+    ovyl_log_storage_record_hdr_t hdr[2];
+    bool loaded[2];
+    bool done[2];
+    struct fcb_entry lane_loc;
+    int cur;
+    size_t hdr_pos;
+    size_t payload_pos;
+    uint64_t since_key; /* Lane records ordered before the first main record are outside a --since bound. */
+    bool since;
+    bool until;
+} ovyl_log_storage_merge_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+/**
+ * @brief Pre-erased region written without locks once the system panics.
+ *
+ * Data is stored as chunks of a 16-bit magic, a 16-bit payload length and the
+ * payload, padded to the flash write block. An erased chunk header ends the
+ * region. The next boot copies the chunks into the main log and erases it.
+ */
+typedef struct {
+    off_t off;
+    size_t size;
+    uint32_t first_sector;
+    size_t wr;
+    uint32_t align;
+    size_t len;
+    uint8_t buf[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + LOG_STORAGE_PANIC_CHUNK_SIZE + LOG_STORAGE_PANIC_ALIGN_MAX];
+    bool ready;
+} ovyl_log_storage_panic_region_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+/** @brief Producer ring and the writer thread draining it. */
+typedef struct {
+    ovyl_log_storage_ring_t ring;
+    struct k_sem data_sem;
+    struct k_thread thread;
+    bool thread_started;
+} ovyl_log_storage_async_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+/** @brief Scratch buffers and decode cache for compressed entries. */
+typedef struct {
+    uint8_t encoded[LOG_STORAGE_ENTRY_HDR_SIZE + OVYL_LOG_COMPRESS_BOUND(LOG_STORAGE_COMPRESS_MAX_INPUT)];
+    uint8_t decoded[LOG_STORAGE_COMPRESS_MAX_INPUT];
+    ovyl_log_compress_ctx_t encoder; /* Match table; too large for the writer thread's stack. */
+    struct fcb_entry cached_loc; /* Entry described by the fields below. */
+    bool cached_in_ram;          /* Payload lives in decoded[] rather than flash. */
+    uint16_t cached_data_off;    /* Payload offset within the entry when read from flash. */
+    size_t cached_len;
+    uint64_t encode_cycles;
+    uint64_t decode_cycles;
+} ovyl_log_storage_compress_t;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+/**
+ * @brief Wear accounting and write-budget governor.
+ *
+ * @c rec is the persisted part. The hourly window starts at @c hour_start_ms
+ * (uptime); powered-on time up to @c minute_base_ms is already in
+ * @c rec.minutes.
+ */
+typedef struct {
+    ovyl_log_storage_wear_t rec;
+    struct k_work_delayable persist_work;
+    int64_t hour_start_ms;
+    int64_t minute_base_ms;
+    uint32_t hour_bytes;
+    uint32_t last_hour_bytes;
+    uint32_t budget_per_hour;
+    uint32_t max_erases;
+    uint32_t throttled;
+    volatile ovyl_log_storage_wear_state_t state;
+} ovyl_log_storage_governor_t;
+#endif
+
+/** @brief Internal module state. */
+typedef struct {
+    const struct flash_area *fa;
+    struct fcb fcb_inst;
+    struct flash_sector sectors[LOG_STORAGE_NUM_SECTORS];
+    uint32_t layout_tag;
+    ovyl_log_storage_metadata_t metadata;
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    ovyl_log_storage_floor_t floor;
+#endif
+    struct k_mutex *lock; /* Front end mutex, see log_storage_backend.h. */
+    ovyl_log_storage_snapshot_t snapshot;
+    ovyl_log_storage_export_filter_t *export_filter; /* Filter of the running export. */
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    ovyl_log_storage_staging_t staging;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    ovyl_log_storage_async_t async;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    struct k_work erase_ahead_work;
+    volatile bool erase_ahead_enabled;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    ovyl_log_storage_compress_t compress;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+    ovyl_log_storage_upload_t upload;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    ovyl_log_storage_time_index_t time_index;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+    ovyl_log_storage_read_ahead_t read_ahead;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    atomic_t record_seq;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    ovyl_log_storage_lane_t lane;
+    ovyl_log_storage_merge_t merge;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    ovyl_log_storage_panic_region_t panic;
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    ovyl_log_storage_governor_t wear;
+#endif
+    volatile bool panic_mode;
+    ovyl_log_storage_stats_t stats;
+} prv_log_storage_state_t;
+
+static prv_log_storage_state_t prv_inst;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+static K_THREAD_STACK_DEFINE(prv_writer_stack, LOG_STORAGE_WRITER_STACK_SIZE);
+#endif
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_WATERMARK) || defined(CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR)
+/** @brief Capture a sector index and its on-flash header into a persistable position. */
+static int prv_position_capture(const struct flash_sector *sector,
+                                uint32_t elem_off,
+                                ovyl_log_storage_position_t *pos)
+{
+    pos->sector_idx = (uint8_t)(sector - prv_inst.sectors);
+    pos->elem_off = elem_off;
+
+    return flash_area_read(prv_inst.fa, sector->fs_off, pos->sector_hdr, sizeof(pos->sector_hdr));
+}
+
+/**
+ * @brief Map a persisted position back onto a sector that still holds the same data.
+ *
+ * @retval 0 @p sector is set and its header matches the recorded one.
+ * @retval -ESTALE The sector was erased or reused since the position was taken.
+ */
+static int prv_position_resolve(const ovyl_log_storage_position_t *pos, struct flash_sector **sector)
+{
+    uint8_t hdr[OVYL_LOG_STORAGE_SECTOR_HDR_SIZE];
+
+    if (pos->sector_idx >= prv_inst.fcb_inst.f_sector_cnt) {
+        return -ESTALE;
+    }
+
+    struct flash_sector *candidate = &prv_inst.sectors[pos->sector_idx];
+
+    if ((pos->elem_off < OVYL_LOG_STORAGE_SECTOR_HDR_SIZE) || (pos->elem_off > candidate->fs_size)) {
+        return -ESTALE;
+    }
+
+    if ((flash_area_read(prv_inst.fa, candidate->fs_off, hdr, sizeof(hdr)) < 0) ||
+        (memcmp(hdr, pos->sector_hdr, sizeof(hdr)) != 0)) {
+        return -ESTALE;
+    }
+
+    *sector = candidate;
+    return 0;
+}
+#endif
+
+/** @brief Forget any cached view of stored entries after sectors are erased. */
+static void prv_invalidate_entry_cache(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    memset(&prv_inst.compress.cached_loc, 0, sizeof(prv_inst.compress.cached_loc));
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+    prv_inst.read_ahead.len = 0U;
+#endif
+}
+
+/** @brief Drop read-ahead data overlapping a sector that was just written. Mutex must be held. */
+static void prv_read_ahead_invalidate(const struct flash_sector *sector)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+    ovyl_log_storage_read_ahead_t *ra = &prv_inst.read_ahead;
+
+    if ((ra->len > 0U) && (ra->off < (off_t)(sector->fs_off + sector->fs_size)) &&
+        ((ra->off + (off_t)ra->len) > (off_t)sector->fs_off)) {
+        ra->len = 0U;
+    }
+#else
+    ARG_UNUSED(sector);
+#endif
+}
+
+/**
+ * @brief Read stored entry data, serving it from the read-ahead window when possible.
+ *
+ * Export reads walk the partition sequentially in small pieces; filling a
+ * CONFIG_OVYL_LOG_STORAGE_READ_AHEAD_SIZE window per flash transaction saves
+ * the per-command overhead of SPI NOR. Mutex must be held.
+ */
+static int prv_flash_read(off_t off, void *dst, size_t len)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+    ovyl_log_storage_read_ahead_t *ra = &prv_inst.read_ahead;
+
+    if ((ra->len > 0U) && (off >= ra->off) && ((off + (off_t)len) <= (ra->off + (off_t)ra->len))) {
+        memcpy(dst, &ra->buf[off - ra->off], len);
+        prv_inst.stats.read_ahead_hits++;
+        return 0;
+    }
+
+    if (len < sizeof(ra->buf)) {
+        size_t fill = MIN(sizeof(ra->buf), (size_t)(prv_inst.fa->fa_size - off));
+
+        ra->len = 0U;
+        if ((fill >= len) && (flash_area_read(prv_inst.fa, off, ra->buf, fill) == 0)) {
+            ra->off = off;
+            ra->len = fill;
+            prv_inst.stats.read_ahead_fills++;
+            memcpy(dst, ra->buf, len);
+            return 0;
+        }
+    }
+#endif
+
+    return flash_area_read(prv_inst.fa, off, dst, len);
+}
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_TIME_INDEX) || defined(CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR) || \
+    defined(CONFIG_OVYL_LOG_STORAGE_PAGE_ALIGN)
+/** @brief Offset of the first entry within an FCB sector. */
+static uint32_t prv_fcb_first_elem_off(void)
+{
+    return ROUND_UP(OVYL_LOG_STORAGE_SECTOR_HDR_SIZE, MAX(prv_inst.fcb_inst.f_align, 1U));
+}
+
+/** @brief Index of @p sector within the partition. */
+static size_t prv_sector_idx(const struct flash_sector *sector)
+{
+    return (size_t)(sector - prv_inst.sectors);
+}
+
+/**
+ * @brief Decode the entry starting at @p elem_off of a sector without walking the FCB.
+ *
+ * @retval 0 @p loc describes the entry.
+ * @retval -ENOENT Nothing has been written at that offset.
+ */
+static int prv_sector_entry_at(struct flash_sector *sector, uint32_t elem_off, struct fcb_entry *loc)
+{
+    uint32_t align = MAX(prv_inst.fcb_inst.f_align, 1U);
+    uint8_t len_buf[2];
+
+    if ((elem_off + sizeof(len_buf)) > sector->fs_size) {
+        return -ENOENT;
+    }
+
+    if (prv_flash_read(sector->fs_off + elem_off, len_buf, sizeof(len_buf)) < 0) {
+        return -EIO;
+    }
+
+    if (len_buf[0] == prv_inst.fcb_inst.f_erase_value) {
+        return -ENOENT;
+    }
+
+    uint16_t len = len_buf[0];
+    uint32_t len_bytes = 1U;
+
+    if ((len_buf[0] & 0x80U) != 0U) {
+        len = (len_buf[0] & 0x7FU) | ((uint16_t)len_buf[1] << 7);
+        len_bytes = 2U;
+    }
+
+    loc->fe_sector = sector;
+    loc->fe_elem_off = elem_off;
+    loc->fe_data_off = elem_off + ROUND_UP(len_bytes, align);
+    loc->fe_data_len = len;
+
+    return 0;
+}
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+/** @brief Age of @p sector in sectors, counting from the oldest FCB sector. */
+static size_t prv_sector_age(const struct flash_sector *sector)
+{
+    size_t cnt = prv_inst.fcb_inst.f_sector_cnt;
+
+    return (prv_sector_idx(sector) + cnt - prv_sector_idx(prv_inst.fcb_inst.f_oldest)) % cnt;
+}
+
+/** @brief Check whether the last logical clear hides the entry at @p elem_off of @p sector. */
+static bool prv_floor_hides(const struct flash_sector *sector, uint32_t elem_off)
+{
+    const ovyl_log_storage_floor_t *floor = &prv_inst.floor;
+
+    if (floor->sector == NULL) {
+        return false;
+    }
+
+    return (prv_sector_age(sector) < prv_sector_age(floor->sector)) ||
+           ((sector == floor->sector) && (elem_off < floor->elem_off));
+}
+
+/**
+ * @brief Find the first entry written after the last logical clear. Mutex must be held.
+ *
+ * @retval 0 @p loc describes that entry.
+ * @retval -ENOENT Nothing was written since the clear.
+ */
+static int prv_floor_first_entry(struct fcb_entry *loc)
+{
+    ovyl_log_storage_floor_t *floor = &prv_inst.floor;
+    int ret = prv_sector_entry_at(floor->sector, floor->elem_off, loc);
+
+    if ((ret != -ENOENT) || (floor->sector == prv_inst.fcb_inst.f_active.fe_sector)) {
+        return ret;
+    }
+
+    /* The first entry after the clear did not fit and opened the next sector. */
+    size_t next = (prv_sector_idx(floor->sector) + 1U) % prv_inst.fcb_inst.f_sector_cnt;
+
+    return prv_sector_entry_at(&prv_inst.sectors[next], prv_fcb_first_elem_off(), loc);
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR */
+
+/** @brief Oldest sector readers can see: the FCB's oldest, or the one a logical clear started in. */
+static struct flash_sector *prv_visible_oldest(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if (prv_inst.floor.sector != NULL) {
+        return prv_inst.floor.sector;
+    }
+#endif
+
+    return prv_inst.fcb_inst.f_oldest;
+}
+
+/**
+ * @brief Advance to the next FCB entry, reporting the end of the active sector as -ENOENT.
+ *
+ * On failure @p loc is left untouched: fcb_getnext() moves it onto the free
+ * offset, from where the next call would skip the first entry written there.
+ */
+static int prv_fcb_getnext(struct fcb_entry *loc)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if ((loc->fe_sector == NULL) && (prv_inst.floor.sector != NULL)) {
+        return prv_floor_first_entry(loc);
+    }
+#endif
+
+    struct fcb_entry prev = *loc;
+    int ret = fcb_getnext(&prv_inst.fcb_inst, loc);
+
+    if (ret < 0) {
+        *loc = prev;
+    }
+
+    return (ret == -ENOTSUP) ? -ENOENT : ret;
+}
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_STAGING) || defined(CONFIG_OVYL_LOG_STORAGE_TIME_INDEX) || \
+    defined(CONFIG_OVYL_LOG_STORAGE_WEAR)
+/**
+ * @brief Flash bytes FCB spends on an entry beyond its payload.
+ *
+ * Covers the length prefix, the trailing CRC byte and the padding applied to
+ * each of them (and to the payload) to honour the flash write alignment.
+ */
+static uint32_t prv_fcb_entry_overhead(size_t len)
+{
+    uint32_t align = MAX(prv_inst.fcb_inst.f_align, 1U);
+    uint32_t len_bytes = (len < 0x80U) ? 1U : 2U;
+
+    return ROUND_UP(len_bytes, align) + ROUND_UP(1U, align) + (ROUND_UP(len, align) - len);
+}
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/** @brief Time key for the current boot and uptime. */
+static uint64_t prv_time_key_now(void)
+{
+    return LOG_STORAGE_TIME_KEY(prv_inst.time_index.boot_id, k_uptime_get());
+}
+
+/**
+ * @brief Decode the first entry of a sector without walking the FCB.
+ *
+ * @retval 0 @p loc describes the first entry.
+ * @retval -ENOENT The sector holds no entries.
+ */
+static int prv_sector_first_entry(struct flash_sector *sector, struct fcb_entry *loc)
+{
+    return prv_sector_entry_at(sector, prv_fcb_first_elem_off(), loc);
+}
+
+/** @brief Read the time key of an entry's marker prefix, if it has one. */
+static bool prv_entry_marker_key(const struct fcb_entry *loc, uint64_t *key)
+{
+    uint8_t marker[LOG_STORAGE_MARKER_SIZE];
+
+    if (loc->fe_data_len < LOG_STORAGE_MARKER_SIZE) {
+        return false;
+    }
+
+    if (prv_flash_read(FCB_ENTRY_FA_DATA_OFF((*loc)), marker, sizeof(marker)) < 0) {
+        return false;
+    }
+
+    if (sys_get_le32(marker) != LOG_STORAGE_MARKER_MAGIC) {
+        return false;
+    }
+
+    *key = LOG_STORAGE_TIME_KEY(sys_get_le16(&marker[4]), sys_get_le64(&marker[8]));
+    return true;
+}
+
+/** @brief Bytes at the start of an entry taken by a marker prefix. Mutex must be held. */
+static uint32_t prv_entry_base(const struct fcb_entry *loc)
+{
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    uint64_t key;
+
+    if ((ti->marker_loc.fe_sector != loc->fe_sector) || (ti->marker_loc.fe_elem_off != loc->fe_elem_off)) {
+        ti->marker_loc = *loc;
+        ti->marker_base = prv_entry_marker_key(loc, &key) ? LOG_STORAGE_MARKER_SIZE : 0U;
+    }
+
+    return ti->marker_base;
+}
+
+/** @brief Fill a marker carrying the current boot id and uptime, or the key of recovered panic logs. */
+static void prv_marker_build(uint8_t *marker)
+{
+    const ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    uint16_t boot_id = ti->boot_id;
+    uint64_t uptime_ms = (uint64_t)k_uptime_get();
+
+    if (ti->recover_key != LOG_STORAGE_TIME_KEY_NONE) {
+        boot_id = (uint16_t)(ti->recover_key >> 48);
+        uptime_ms = ti->recover_key & BIT64_MASK(48);
+    }
+
+    memset(marker, 0, LOG_STORAGE_MARKER_SIZE);
+    sys_put_le32(LOG_STORAGE_MARKER_MAGIC, marker);
+    sys_put_le16(boot_id, &marker[4]);
+    sys_put_le64(uptime_ms, &marker[8]);
+}
+
+/**
+ * @brief Check whether the next append must carry a marker.
+ *
+ * Entries that open a sector are marked so the index can be rebuilt from the
+ * first entry of each sector; the first entry of a boot is marked so the boot
+ * id survives a reboot that never fills a sector.
+ */
+static bool prv_marker_needed(size_t len)
+{
+    struct fcb_entry *active = &prv_inst.fcb_inst.f_active;
+
+    if (!prv_inst.time_index.boot_marked || (active->fe_sector == NULL) ||
+        (active->fe_elem_off <= prv_fcb_first_elem_off())) {
+        return true;
+    }
+
+    return (active->fe_elem_off + len + prv_fcb_entry_overhead(len)) > active->fe_sector->fs_size;
+}
+
+/**
+ * @brief Rebuild the sector index and pick this boot's id from the stored markers.
+ *
+ * Reads the first entry of every used sector and walks the active sector,
+ * which holds the newest boot markers. Mutex must be held.
+ */
+static void prv_time_index_rebuild(void)
+{
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    struct fcb *fcb = &prv_inst.fcb_inst;
+    uint64_t newest = LOG_STORAGE_TIME_KEY_NONE;
+    bool found = false;
+
+    for (size_t i = 0; i < ARRAY_SIZE(ti->first_key); i++) {
+        ti->first_key[i] = LOG_STORAGE_TIME_KEY_NONE;
+    }
+
+    ti->boot_marked = false;
+    ti->recover_key = LOG_STORAGE_TIME_KEY_NONE;
+    memset(&ti->marker_loc, 0, sizeof(ti->marker_loc));
+
+    if ((fcb->f_oldest == NULL) || (fcb->f_active.fe_sector == NULL)) {
+        ti->boot_id = 0U;
+        return;
+    }
+
+    size_t idx = prv_sector_idx(fcb->f_oldest);
+
+    while (true) {
+        struct flash_sector *sector = &prv_inst.sectors[idx];
+        struct fcb_entry loc;
+        uint64_t key;
+
+        if (prv_sector_first_entry(sector, &loc) == 0) {
+            if (prv_entry_marker_key(&loc, &key)) {
+                ti->first_key[idx] = key;
+                newest = found ? MAX(newest, key) : key;
+                found = true;
+            }
+
+            while ((sector == fcb->f_active.fe_sector) && (prv_fcb_getnext(&loc) == 0) &&
+                   (loc.fe_sector == sector)) {
+                if (prv_entry_marker_key(&loc, &key)) {
+                    newest = found ? MAX(newest, key) : key;
+                    found = true;
+                }
+            }
+        }
+
+        if (sector == fcb->f_active.fe_sector) {
+            break;
+        }
+
+        idx = (idx + 1U) % fcb->f_sector_cnt;
+    }
+
+    ti->boot_id = found ? (uint16_t)((newest >> 48) + 1U) : 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    ovyl_log_storage_floor_t *floor = &prv_inst.floor;
+
+    if (floor->sector == NULL) {
+        return;
+    }
+
+    /* Hidden entries must not be found by a seek; the floor entry stands in for its sector. */
+    idx = prv_sector_idx(fcb->f_oldest);
+    while (true) {
+        ti->first_key[idx] = LOG_STORAGE_TIME_KEY_NONE;
+        if (&prv_inst.sectors[idx] == floor->sector) {
+            break;
+        }
+        idx = (idx + 1U) % fcb->f_sector_cnt;
+    }
+
+    struct fcb_entry loc;
+    uint64_t key;
+
+    if ((prv_sector_entry_at(floor->sector, floor->elem_off, &loc) == 0) && prv_entry_marker_key(&loc, &key)) {
+        ti->first_key[idx] = key;
+    }
+#endif
+}
+
+/**
+ * @brief Find the first entry of the sector holding @p key. Mutex must be held.
+ *
+ * Picks the newest sector whose first key is not after @p key, or the oldest
+ * indexed sector when @p key predates everything stored.
+ *
+ * @retval 0 @p loc describes the first entry of that sector.
+ * @retval -ENOENT No indexed sector.
+ */
+static int prv_time_index_seek(uint64_t key, struct fcb_entry *loc)
+{
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    struct fcb *fcb = &prv_inst.fcb_inst;
+    struct flash_sector *target = NULL;
+
+    if (fcb->f_active.fe_sector == NULL) {
+        return -ENOENT;
+    }
+
+    size_t idx = prv_sector_idx(fcb->f_oldest);
+
+    while (true) {
+        uint64_t first = ti->first_key[idx];
+
+        if (first != LOG_STORAGE_TIME_KEY_NONE) {
+            if ((target != NULL) && (first > key)) {
+                break;
+            }
+
+            target = &prv_inst.sectors[idx];
+        }
+
+        if (&prv_inst.sectors[idx] == fcb->f_active.fe_sector) {
+            break;
+        }
+
+        idx = (idx + 1U) % fcb->f_sector_cnt;
+    }
+
+    if (target == NULL) {
+        return -ENOENT;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if (target == prv_inst.floor.sector) {
+        return prv_floor_first_entry(loc);
+    }
+#endif
+
+    return prv_sector_first_entry(target, loc);
+}
+#else
+/** @brief Bytes at the start of an entry taken by a marker prefix; none without the time index. */
+static uint32_t prv_entry_base(const struct fcb_entry *loc)
+{
+    ARG_UNUSED(loc);
+
+    return 0U;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_TIME_INDEX */
+
+/** @brief Capture the current write position as the end of an export snapshot. Mutex must be held. */
+static void prv_snapshot_begin(void)
+{
+    prv_inst.snapshot.end = prv_inst.fcb_inst.f_active;
+    prv_inst.snapshot.pin = prv_visible_oldest();
+    prv_inst.snapshot.active = true;
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    prv_inst.snapshot.until = LOG_STORAGE_TIME_KEY_NONE;
+#endif
+}
+
+/** @brief Release the export snapshot so rotation may proceed freely. Mutex must be held. */
+static void prv_snapshot_end(void)
+{
+    memset(&prv_inst.snapshot, 0, sizeof(prv_inst.snapshot));
+    prv_inst.export_filter = NULL;
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    prv_inst.lane.pin = NULL;
+#endif
+}
+
+/** @brief Check whether erasing the oldest sector would discard entries an export has not read yet. */
+static bool prv_snapshot_blocks_rotate(void)
+{
+    /* Sectors older than the pin were already exported; a panic always wins. */
+    return prv_inst.snapshot.active && !prv_inst.panic_mode &&
+           (prv_inst.snapshot.pin == prv_inst.fcb_inst.f_oldest);
+}
+
+/**
+ * @brief Advance an export cursor within the snapshot. Mutex must be held.
+ *
+ * @retval 0 @p loc describes the next entry.
+ * @retval -ENOENT The snapshot end was reached.
+ */
+static int prv_snapshot_next(struct fcb_entry *loc)
+{
+    ovyl_log_storage_snapshot_t *snap = &prv_inst.snapshot;
+    struct fcb_entry prev = *loc;
+
+    if (!snap->active) {
+        return prv_fcb_getnext(loc);
+    }
+
+    int ret = prv_fcb_getnext(loc);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    struct flash_sector *from = (prev.fe_sector != NULL) ? prev.fe_sector : prv_visible_oldest();
+
+    if (((from == snap->end.fe_sector) && (loc->fe_sector != from)) ||
+        ((loc->fe_sector == snap->end.fe_sector) && (loc->fe_elem_off >= snap->end.fe_elem_off))) {
+        *loc = prev;
+        return -ENOENT;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    uint64_t first = prv_inst.time_index.first_key[prv_sector_idx(loc->fe_sector)];
+
+    if ((loc->fe_elem_off == prv_fcb_first_elem_off()) && (first != LOG_STORAGE_TIME_KEY_NONE) &&
+        (first > snap->until)) {
+        /* The rest of the snapshot was written after the requested end time. */
+        *loc = prev;
+        return -ENOENT;
+    }
+#endif
+
+    snap->pin = loc->fe_sector;
+    return 0;
+}
+
+/** @brief Check whether a reader had not finished @p arg, the sector being erased. */
+static bool prv_reader_in_sector(const ovyl_log_storage_read_ctx_t *ctx, void *arg)
+{
+    return (ctx->head.fe_sector == NULL) || (ctx->head.fe_sector == arg);
+}
+
+/**
+ * @brief Move readers positioned in an erased sector back to the oldest entry.
+ *
+ * @param erased Sector that was erased, or NULL when every sector was cleared.
+ */
+static void prv_cursors_drop_sector(const struct flash_sector *erased)
+{
+    if (erased == NULL) {
+        ovyl_log_storage_readers_drop(NULL, NULL);
+    } else {
+        ovyl_log_storage_readers_drop(prv_reader_in_sector, (void *)erased);
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+
+    if (erased == NULL) {
+        for (size_t i = 0; i < ARRAY_SIZE(ti->first_key); i++) {
+            ti->first_key[i] = LOG_STORAGE_TIME_KEY_NONE;
+        }
+        ti->boot_marked = false;
+    } else {
+        ti->first_key[erased - prv_inst.sectors] = LOG_STORAGE_TIME_KEY_NONE;
+    }
+
+    memset(&ti->marker_loc, 0, sizeof(ti->marker_loc));
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+    ovyl_log_storage_upload_t *up = &prv_inst.upload;
+
+    if ((erased == NULL) || (up->ctx.head.fe_sector == erased)) {
+        memset(&up->ctx, 0, sizeof(up->ctx));
+        up->resume = false;
+    }
+
+    if ((erased == NULL) || (up->delivered.fe_sector == erased)) {
+        memset(&up->delivered, 0, sizeof(up->delivered));
+    }
+
+    if ((erased == NULL) || (up->acked.fe_sector == erased)) {
+        memset(&up->acked, 0, sizeof(up->acked));
+    }
+#endif
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+/** @brief Fold the powered-on minutes elapsed since the last call into the wear record. */
+static void prv_wear_minutes_update(void)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    int64_t minutes = (k_uptime_get() - g->minute_base_ms) / LOG_STORAGE_WEAR_MINUTE_MS;
+
+    g->rec.minutes += (uint32_t)minutes;
+    g->minute_base_ms += minutes * LOG_STORAGE_WEAR_MINUTE_MS;
+}
+
+/**
+ * @brief Recompute the hourly write budget. Mutex must be held.
+ *
+ * Every byte written to a log sector uses up one byte of one erase cycle of
+ * that sector, so the budget is the byte-cycles left in the main log and the
+ * priority lane spread over the powered-on hours left in the configured
+ * lifetime. The lane directly follows the main log in the sector table.
+ */
+static void prv_wear_budget_update(void)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    uint32_t hours = g->rec.minutes / 60U;
+    uint32_t hours_left = (hours < LOG_STORAGE_WEAR_LIFETIME_HOURS) ? (LOG_STORAGE_WEAR_LIFETIME_HOURS - hours) : 1U;
+    uint32_t sector_cnt = prv_inst.fcb_inst.f_sector_cnt;
+    uint64_t capacity = 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if (prv_inst.lane.ready) {
+        sector_cnt += LOG_STORAGE_LANE_SECTORS;
+    }
+#endif
+
+    g->max_erases = 0U;
+
+    for (uint32_t i = 0; i < sector_cnt; i++) {
+        uint32_t erases = g->rec.erases[i];
+
+        g->max_erases = MAX(g->max_erases, erases);
+        if (erases < LOG_STORAGE_WEAR_CYCLES) {
+            capacity += (uint64_t)prv_inst.sectors[i].fs_size * (LOG_STORAGE_WEAR_CYCLES - erases);
+        }
+    }
+
+    g->budget_per_hour = (uint32_t)MIN(capacity / hours_left, (uint64_t)UINT32_MAX);
+}
+
+/**
+ * @brief Pick the governor state from the writes of this hour and the last one.
+ *
+ * Reaching half the budget within the hour, or having overrun it during the
+ * previous hour, raises the stored level; spending all of it stops flash
+ * writes until the hour is over.
+ */
+static void prv_wear_govern(void)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    ovyl_log_storage_wear_state_t state = OVYL_LOG_STORAGE_WEAR_NORMAL;
+
+    if (g->hour_bytes >= g->budget_per_hour) {
+        state = OVYL_LOG_STORAGE_WEAR_THROTTLED;
+    } else if ((g->last_hour_bytes > g->budget_per_hour) || (g->hour_bytes >= (g->budget_per_hour / 2U))) {
+        state = OVYL_LOG_STORAGE_WEAR_RAISED;
+    }
+
+    bool escalated = (state > g->state);
+
+    /* Set before logging: the warning itself may come back through this path. */
+    g->state = state;
+
+    if (escalated && !prv_inst.snapshot.active) {
+        LOG_WRN("Log write budget of %u bytes/hour %s",
+                g->budget_per_hour,
+                (state == OVYL_LOG_STORAGE_WEAR_THROTTLED) ? "spent; throttling flash writes"
+                                                           : "nearly spent; storing fewer levels");
+    }
+}
+
+/** @brief Start a new hourly window once the current one is over. Mutex must be held. */
+static void prv_wear_roll(void)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    int64_t elapsed = k_uptime_get() - g->hour_start_ms;
+
+    if (elapsed < LOG_STORAGE_WEAR_HOUR_MS) {
+        return;
+    }
+
+    /* An hour without writes in between leaves nothing to carry over. */
+    g->last_hour_bytes = (elapsed < (2 * LOG_STORAGE_WEAR_HOUR_MS)) ? g->hour_bytes : 0U;
+    g->hour_bytes = 0U;
+    g->hour_start_ms += (elapsed / LOG_STORAGE_WEAR_HOUR_MS) * LOG_STORAGE_WEAR_HOUR_MS;
+
+    prv_wear_minutes_update();
+    prv_wear_budget_update();
+    prv_wear_govern();
+}
+
+/** @brief Work handler that persists the wear record through Ovyl Config. */
+static void prv_wear_persist_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    ovyl_log_storage_wear_t rec;
+
+    if (prv_inst.panic_mode) {
+        return;
+    }
+
+    if (k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        k_work_schedule(&g->persist_work, K_MSEC(LOG_STORAGE_WEAR_RETRY_MS));
+        return;
+    }
+
+    prv_wear_roll();
+    prv_wear_minutes_update();
+    prv_wear_budget_update();
+    prv_wear_govern();
+    rec = g->rec;
+
+    k_mutex_unlock(prv_inst.lock);
+
+    if (!ovyl_config_mgr_set_value(CFG_LOG_STORAGE_WEAR, &rec, sizeof(rec))) {
+        LOG_WRN("Failed to persist wear counters");
+    }
+
+    k_work_schedule(&g->persist_work, K_MINUTES(CONFIG_OVYL_LOG_STORAGE_WEAR_PERSIST_MIN));
+}
+
+/** @brief Restore the wear record, starting over when the sector table changed. */
+static void prv_wear_load(uint32_t sector_count)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+
+    memset(g, 0, sizeof(*g));
+
+    if (!ovyl_config_mgr_get_value(CFG_LOG_STORAGE_WEAR, &g->rec, sizeof(g->rec)) ||
+        (g->rec.magic != LOG_STORAGE_WEAR_MAGIC) || (g->rec.sector_cnt != sector_count)) {
+        if (g->rec.magic == LOG_STORAGE_WEAR_MAGIC) {
+            LOG_WRN("Sector table changed; wear counters restart");
+        }
+
+        memset(&g->rec, 0, sizeof(g->rec));
+        g->rec.magic = LOG_STORAGE_WEAR_MAGIC;
+        g->rec.sector_cnt = (uint8_t)sector_count;
+    }
+
+    g->hour_start_ms = k_uptime_get();
+    g->minute_base_ms = g->hour_start_ms;
+    k_work_init_delayable(&g->persist_work, prv_wear_persist_work_handler);
+}
+
+/** @brief Compute the first budget once the FCB is up and schedule persisting. */
+static void prv_wear_start(void)
+{
+    prv_wear_budget_update();
+    prv_wear_govern();
+    k_work_schedule(&prv_inst.wear.persist_work, K_MINUTES(CONFIG_OVYL_LOG_STORAGE_WEAR_PERSIST_MIN));
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WEAR */
+
+/** @brief Count one erase of @p cnt consecutive sectors starting at @p first. Mutex must be held. */
+static void prv_wear_count_erase(const struct flash_sector *first, uint32_t cnt)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    size_t idx = (size_t)(first - prv_inst.sectors);
+
+    for (size_t i = idx; (i < (idx + cnt)) && (i < prv_inst.wear.rec.sector_cnt); i++) {
+        prv_inst.wear.rec.erases[i]++;
+    }
+#else
+    ARG_UNUSED(first);
+    ARG_UNUSED(cnt);
+#endif
+}
+
+/**
+ * @brief Count the erases fcb_clear() is about to perform on @p fcb. Mutex must be held.
+ *
+ * fcb_clear() rotates until the FCB is empty, erasing every sector from the
+ * oldest through the active one.
+ */
+static void prv_wear_count_clear(struct fcb *fcb)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    const struct flash_sector *sector = fcb->f_oldest;
+    const struct flash_sector *last = &fcb->f_sectors[fcb->f_sector_cnt - 1U];
+
+    if ((sector == NULL) || fcb_is_empty(fcb)) {
+        return;
+    }
+
+    for (;;) {
+        prv_wear_count_erase(sector, 1U);
+
+        if (sector == fcb->f_active.fe_sector) {
+            break;
+        }
+
+        sector = (sector == last) ? fcb->f_sectors : (sector + 1);
+    }
+#else
+    ARG_UNUSED(fcb);
+#endif
+}
+
+/**
+ * @brief Check the write budget before a main-log or lane write. Mutex must be held.
+ *
+ * @retval false The governor is throttling; the write must be dropped.
+ */
+static bool prv_wear_admit(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    prv_wear_roll();
+
+    /* Whatever explains a crash is worth the wear. */
+    if ((prv_inst.wear.state == OVYL_LOG_STORAGE_WEAR_THROTTLED) && !prv_inst.panic_mode) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/** @brief Count @p msgs messages the governor kept out of flash. Mutex must be held. */
+static void prv_wear_throttled(uint32_t msgs)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    prv_inst.wear.throttled += msgs;
+#else
+    ARG_UNUSED(msgs);
+#endif
+}
+
+/** @brief Charge a main-log or lane entry of @p entry_size bytes to the write budget. Mutex must be held. */
+static void prv_wear_account(size_t entry_size)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+    uint32_t bytes = (uint32_t)entry_size + prv_fcb_entry_overhead(entry_size);
+
+    g->hour_bytes += bytes;
+    g->rec.bytes += bytes;
+    prv_wear_govern();
+#else
+    ARG_UNUSED(entry_size);
+#endif
+}
+
+/** @brief Erase the oldest FCB sector. Mutex must be held. */
+static int prv_fcb_rotate(void)
+{
+    struct flash_sector *oldest = prv_inst.fcb_inst.f_oldest;
+    bool hidden = false;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    /* No reader can be inside a sector hidden by a logical clear. */
+    hidden = (prv_inst.floor.sector != NULL) && (prv_inst.floor.sector != oldest);
+#endif
+
+    int ret = fcb_rotate(&prv_inst.fcb_inst);
+
+    if (ret == 0) {
+        prv_wear_count_erase(oldest, 1U);
+    }
+
+    if ((ret == 0) && !hidden) {
+        prv_cursors_drop_sector(oldest);
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if ((ret == 0) && (prv_inst.floor.sector == oldest)) {
+        /* The last cleared entries are gone; the persisted floor no longer resolves either. */
+        prv_inst.floor.sector = NULL;
+    }
+#endif
+
+    prv_invalidate_entry_cache();
+
+    return ret;
+}
+
+/** @brief Erase every FCB sector. Mutex must be held. */
+static int prv_fcb_clear(void)
+{
+    prv_wear_count_clear(&prv_inst.fcb_inst);
+
+    int ret = fcb_clear(&prv_inst.fcb_inst);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    prv_inst.floor.sector = NULL;
+#endif
+    prv_cursors_drop_sector(NULL);
+    prv_invalidate_entry_cache();
+
+    return ret;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+/** @brief Mount the priority lane on the sectors after the main log, reformatting foreign data. */
+static int prv_lane_init(uint32_t first_sector)
+{
+    struct fcb *fcb = &prv_inst.lane.fcb;
+    int ret = 0;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        memset(fcb, 0, sizeof(*fcb));
+        fcb->f_magic = LOG_STORAGE_LANE_MAGIC ^ prv_inst.layout_tag;
+        fcb->f_sectors = &prv_inst.sectors[first_sector];
+        fcb->f_sector_cnt = (uint8_t)LOG_STORAGE_LANE_SECTORS;
+
+        ret = fcb_init(LOG_STORAGE_FLASH_AREA_ID, fcb);
+        if (ret == 0) {
+            break;
+        }
+
+        /* The sectors still hold main-log data from before the lane existed. */
+        LOG_WRN("Priority lane unreadable (%d); erasing it", ret);
+        for (uint32_t i = 0; i < LOG_STORAGE_LANE_SECTORS; i++) {
+            const struct flash_sector *sector = &prv_inst.sectors[first_sector + i];
+
+            (void)flash_area_erase(prv_inst.fa, sector->fs_off, sector->fs_size);
+        }
+        prv_wear_count_erase(&prv_inst.sectors[first_sector], LOG_STORAGE_LANE_SECTORS);
+    }
+
+    prv_inst.lane.ready = (ret == 0);
+    return ret;
+}
+
+/** @brief Append one record to the priority lane, rotating its oldest sector when full. Mutex must be held. */
+static int prv_lane_append(const uint8_t *record, size_t len)
+{
+    ovyl_log_storage_lane_t *lane = &prv_inst.lane;
+    struct fcb_entry loc = {0};
+
+    if (!lane->ready) {
+        return -ENODEV;
+    }
+
+    if (!prv_wear_admit()) {
+        prv_wear_throttled(1U);
+        return 0;
+    }
+
+    int ret = fcb_append(&lane->fcb, len, &loc);
+
+    if (ret == -ENOSPC) {
+        if ((lane->pin == lane->fcb.f_oldest) && !prv_inst.panic_mode) {
+            /* An export is still reading the oldest lane sector; the record is dropped. */
+            prv_inst.stats.export_dropped++;
+            return 0;
+        }
+
+        struct flash_sector *oldest = lane->fcb.f_oldest;
+
+        ret = fcb_rotate(&lane->fcb);
+        if (ret == 0) {
+            prv_wear_count_erase(oldest, 1U);
+            ret = fcb_append(&lane->fcb, len, &loc);
+        }
+    }
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    prv_read_ahead_invalidate(loc.fe_sector);
+
+    ret = flash_area_write(prv_inst.fa, FCB_ENTRY_FA_DATA_OFF(loc), record, len);
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = fcb_append_finish(&lane->fcb, &loc);
+    if (ret == 0) {
+        prv_inst.stats.lane_records++;
+        prv_wear_account(len);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance to the next lane entry written before the export started. Mutex must be held.
+ *
+ * @retval 0 @p loc describes the next entry.
+ * @retval -ENOENT The lane end was reached; @p loc is unchanged.
+ */
+static int prv_lane_next(struct fcb_entry *loc)
+{
+    ovyl_log_storage_lane_t *lane = &prv_inst.lane;
+    struct fcb_entry prev = *loc;
+
+    if (fcb_getnext(&lane->fcb, loc) < 0) {
+        *loc = prev;
+        return -ENOENT;
+    }
+
+    if (((prev.fe_sector == lane->end.fe_sector) && (loc->fe_sector != prev.fe_sector)) ||
+        ((loc->fe_sector == lane->end.fe_sector) && (loc->fe_elem_off >= lane->end.fe_elem_off))) {
+        *loc = prev;
+        return -ENOENT;
+    }
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+/**
+ * @brief Check whether the next sector switch would require an inline rotate.
+ *
+ * FCB needs more than f_scratch_cnt erased sectors ahead of the active one to
+ * open a new sector, so once the active sector is nearly full and no spare
+ * sector remains, the oldest sector should be erased ahead of time.
+ */
+static bool prv_erase_ahead_needed(void)
+{
+    struct fcb *fcb = &prv_inst.fcb_inst;
+    struct fcb_entry *active = &fcb->f_active;
+
+    if (active->fe_sector == NULL) {
+        return false;
+    }
+
+    uint32_t sector_free = active->fe_sector->fs_size - active->fe_elem_off;
+
+    if (sector_free >= CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD_THRESHOLD) {
+        return false;
+    }
+
+    return fcb_free_sector_cnt(fcb) <= fcb->f_scratch_cnt;
+}
+
+/** @brief Work handler that erases the oldest sector before the writer needs it. */
+static void prv_erase_ahead_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    if (k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        return;
+    }
+
+    if (prv_inst.erase_ahead_enabled && !prv_snapshot_blocks_rotate() && prv_erase_ahead_needed()) {
+        int ret = prv_fcb_rotate();
+
+        if (ret < 0) {
+            LOG_ERR("Failed to pre-erase sector: %d", ret);
+        } else {
+            prv_inst.stats.erase_ahead_erases++;
+        }
+    }
+
+    k_mutex_unlock(prv_inst.lock);
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD */
+
+/** @brief Record the duration of one FCB append in the latency statistics. */
+static void prv_record_append_latency(uint32_t start_cycles)
+{
+    uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+    bool erase_ahead = false;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    erase_ahead = prv_inst.erase_ahead_enabled;
+#endif
+
+    if (erase_ahead) {
+        prv_inst.stats.append_max_us_erase_ahead =
+            MAX(prv_inst.stats.append_max_us_erase_ahead, elapsed_us);
+    } else {
+        prv_inst.stats.append_max_us_inline = MAX(prv_inst.stats.append_max_us_inline, elapsed_us);
+    }
+}
+
+/**
+ * @brief Append a single FCB entry, rotating out the oldest sector when full. Mutex must be held.
+ *
+ * The caller counts the messages in an entry that is not written as dropped:
+ *
+ * @retval -EAGAIN The oldest sector is pinned by an export snapshot.
+ * @retval -ENOBUFS The write budget is spent.
+ */
+static int prv_fcb_write(const void *buf, size_t buf_size)
+{
+    struct fcb_entry loc = {0};
+    uint32_t start_cycles = k_cycle_get_32();
+    uint16_t active_id = prv_inst.fcb_inst.f_active_id;
+    size_t entry_size = buf_size;
+    uint32_t data_off = 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    uint8_t marker[LOG_STORAGE_MARKER_SIZE];
+    bool marked = prv_marker_needed(buf_size);
+
+    if (marked) {
+        /* A marked entry is larger than the bare one, so it still opens the new sector. */
+        prv_marker_build(marker);
+        entry_size += sizeof(marker);
+        data_off = sizeof(marker);
+    }
+#endif
+
+    if (!prv_wear_admit()) {
+        return -ENOBUFS;
+    }
+
+    int ret = fcb_append(&prv_inst.fcb_inst, entry_size, &loc);
+
+    if (ret == -ENOSPC) {
+        if (prv_snapshot_blocks_rotate()) {
+            /* The oldest sector is still being exported; drop rather than erase it. */
+            return -EAGAIN;
+        }
+
+        prv_inst.stats.inline_rotations++;
+        ret = prv_fcb_rotate();
+
+        if (ret < 0) {
+            if (!prv_inst.snapshot.active) {
+                LOG_ERR("Failed to rotate sectors: %d", ret);
+            }
+
+            return ret;
+        }
+
+        ret = fcb_append(&prv_inst.fcb_inst, entry_size, &loc);
+    }
+
+    if (ret < 0) {
+        if (!prv_inst.snapshot.active) {
+            LOG_ERR("Failed to get location to write to: %d", ret);
+        }
+        (void)prv_fcb_clear();
+        return ret;
+    }
+
+    /* The entry (and possibly a new sector header) lands where read-ahead may hold erased bytes. */
+    prv_read_ahead_invalidate(loc.fe_sector);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    if (marked) {
+        ret = flash_area_write(prv_inst.fa, FCB_ENTRY_FA_DATA_OFF(loc), marker, sizeof(marker));
+    }
+
+    if (ret == 0)
+#endif
+    {
+        ret = flash_area_write(prv_inst.fa, FCB_ENTRY_FA_DATA_OFF(loc) + data_off, buf, buf_size);
+    }
+
+    if (ret < 0) {
+        if (!prv_inst.snapshot.active) {
+            LOG_ERR("Failed to write to flash: %d", ret);
+        }
+        return ret;
+    }
+
+    ret = fcb_append_finish(&prv_inst.fcb_inst, &loc);
+    if (ret < 0) {
+        if (!prv_inst.snapshot.active) {
+            LOG_ERR("Failed to finalize write: %d", ret);
+        }
+        return ret;
+    }
+
+    prv_record_append_latency(start_cycles);
+
+    /* FCB programs the length prefix and the CRC; a new sector also gets its header. */
+    prv_inst.stats.program_ops += 3U + ((data_off > 0U) ? 1U : 0U) +
+                                  ((prv_inst.fcb_inst.f_active_id != active_id) ? 1U : 0U);
+    prv_inst.stats.program_bytes += buf_size;
+    prv_wear_account(entry_size);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+
+    ti->last_key = prv_time_key_now();
+    if (marked) {
+        bool first = (loc.fe_elem_off == prv_fcb_first_elem_off());
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+        /* The first entry after a clear opens the visible part of its sector. */
+        first = first || ((loc.fe_sector == prv_inst.floor.sector) && (loc.fe_elem_off == prv_inst.floor.elem_off));
+#endif
+
+        ti->boot_marked = true;
+        if (first) {
+            ti->first_key[prv_sector_idx(loc.fe_sector)] = LOG_STORAGE_TIME_KEY(sys_get_le16(&marker[4]),
+                                                                               sys_get_le64(&marker[8]));
+        }
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    if (prv_inst.erase_ahead_enabled && !prv_inst.panic_mode && prv_erase_ahead_needed()) {
+        k_work_submit(&prv_inst.erase_ahead_work);
+    }
+#endif
+
+    return 0;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+/** @brief Compress up to LOG_STORAGE_COMPRESS_MAX_INPUT bytes into one framed FCB entry. Mutex must be held. */
+static int prv_compress_write(const uint8_t *src, size_t len)
+{
+    ovyl_log_storage_compress_t *c = &prv_inst.compress;
+    uint8_t *payload = &c->encoded[LOG_STORAGE_ENTRY_HDR_SIZE];
+    uint32_t start_cycles = k_cycle_get_32();
+
+    size_t enc_len = ovyl_log_compress_encode(&c->encoder,
+                                              src,
+                                              len,
+                                              payload,
+                                              sizeof(c->encoded) - LOG_STORAGE_ENTRY_HDR_SIZE);
+
+    c->encode_cycles += (uint32_t)(k_cycle_get_32() - start_cycles);
+
+    if ((enc_len == 0U) || (enc_len >= len)) {
+        memcpy(payload, src, len);
+        enc_len = len;
+        c->encoded[0] = LOG_STORAGE_ENTRY_RAW;
+    } else {
+        c->encoded[0] = LOG_STORAGE_ENTRY_LZSS;
+    }
+    sys_put_le16((uint16_t)len, &c->encoded[1]);
+
+    prv_inst.stats.compress_bytes_in += len;
+    prv_inst.stats.compress_bytes_out += enc_len + LOG_STORAGE_ENTRY_HDR_SIZE;
+
+    return prv_fcb_write(c->encoded, enc_len + LOG_STORAGE_ENTRY_HDR_SIZE);
+}
+
+/**
+ * @brief Resolve where the payload of @p loc can be read from, decoding it if needed.
+ *
+ * The result is cached so repeated partial reads of the same entry decode once.
+ * Corrupt entries are reported as empty so readers skip them. Mutex must be held.
+ */
+static int prv_entry_load(const struct fcb_entry *loc)
+{
+    ovyl_log_storage_compress_t *c = &prv_inst.compress;
+
+    if ((c->cached_loc.fe_sector == loc->fe_sector) &&
+        (c->cached_loc.fe_elem_off == loc->fe_elem_off)) {
+        return 0;
+    }
+
+    uint8_t hdr[LOG_STORAGE_ENTRY_HDR_SIZE];
+    uint32_t base = prv_entry_base(loc);
+    size_t data_len = loc->fe_data_len - base;
+
+    c->cached_loc = *loc;
+    c->cached_in_ram = false;
+    c->cached_data_off = base;
+    c->cached_len = data_len;
+
+    if (data_len < LOG_STORAGE_ENTRY_HDR_SIZE) {
+        return 0;
+    }
+
+    if (prv_flash_read(FCB_ENTRY_FA_DATA_OFF((*loc)) + base, hdr, sizeof(hdr)) < 0) {
+        memset(&c->cached_loc, 0, sizeof(c->cached_loc));
+        return -EIO;
+    }
+
+    size_t payload_len = data_len - LOG_STORAGE_ENTRY_HDR_SIZE;
+    size_t raw_len = sys_get_le16(&hdr[1]);
+
+    if (hdr[0] == LOG_STORAGE_ENTRY_RAW) {
+        c->cached_data_off = base + LOG_STORAGE_ENTRY_HDR_SIZE;
+        c->cached_len = payload_len;
+        return 0;
+    }
+
+    c->cached_in_ram = true;
+    c->cached_len = 0U;
+
+    if (hdr[0] != LOG_STORAGE_ENTRY_LZSS) {
+        /* The sector magic rules out uncompressed logs, so an unknown method is corruption. */
+        LOG_WRN("Skipping entry with unknown compression method 0x%02x", hdr[0]);
+        return 0;
+    }
+
+    if (payload_len > (sizeof(c->encoded) - LOG_STORAGE_ENTRY_HDR_SIZE)) {
+        LOG_WRN("Skipping oversized compressed entry (%u bytes)", (unsigned int)payload_len);
+        return 0;
+    }
+
+    if (prv_flash_read(FCB_ENTRY_FA_DATA_OFF((*loc)) + base + LOG_STORAGE_ENTRY_HDR_SIZE,
+                       c->encoded,
+                       payload_len) < 0) {
+        memset(&c->cached_loc, 0, sizeof(c->cached_loc));
+        return -EIO;
+    }
+
+    uint32_t start_cycles = k_cycle_get_32();
+    size_t out_len = 0U;
+    int ret = ovyl_log_compress_decode(c->encoded, payload_len, c->decoded, sizeof(c->decoded), &out_len);
+
+    c->decode_cycles += (uint32_t)(k_cycle_get_32() - start_cycles);
+
+    if ((ret < 0) || (out_len != raw_len)) {
+        LOG_WRN("Skipping corrupt compressed entry");
+        return 0;
+    }
+
+    c->cached_len = out_len;
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_COMPRESS */
+
+/** @brief Write data as one or more FCB entries, compressing when enabled. Mutex must be held. */
+static int prv_entry_write(const void *buf, size_t buf_size)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    const uint8_t *src = buf;
+
+    while (buf_size > 0U) {
+        size_t chunk = MIN(buf_size, (size_t)LOG_STORAGE_COMPRESS_MAX_INPUT);
+        int ret = prv_compress_write(src, chunk);
+
+        if (ret < 0) {
+            return ret;
+        }
+
+        src += chunk;
+        buf_size -= chunk;
+    }
+
+    return 0;
+#else
+    return prv_fcb_write(buf, buf_size);
+#endif
+}
+
+/** @brief Payload length of a stored entry as seen by readers. Mutex must be held. */
+static int prv_entry_len(const struct fcb_entry *loc, size_t *len)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    int ret = prv_entry_load(loc);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    *len = prv_inst.compress.cached_len;
+#else
+    *len = loc->fe_data_len - prv_entry_base(loc);
+#endif
+
+    return 0;
+}
+
+/** @brief Read part of a stored entry's payload. Mutex must be held. */
+static int prv_entry_read(const struct fcb_entry *loc, size_t offset, void *dst, size_t len)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    ovyl_log_storage_compress_t *c = &prv_inst.compress;
+    int ret = prv_entry_load(loc);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    if ((offset + len) > c->cached_len) {
+        return -EINVAL;
+    }
+
+    if (c->cached_in_ram) {
+        memcpy(dst, &c->decoded[offset], len);
+        return 0;
+    }
+
+    offset += c->cached_data_off;
+#else
+    offset += prv_entry_base(loc);
+#endif
+
+    if (prv_flash_read(FCB_ENTRY_FA_DATA_OFF((*loc)) + offset, dst, len) < 0) {
+        return -EIO;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Count the @p msgs messages of an entry an export snapshot or the governor kept out of flash.
+ *
+ * @return 0 for such a deliberate drop, otherwise @p ret.
+ */
+static int prv_write_dropped(int ret, uint32_t msgs)
+{
+    if (ret == -EAGAIN) {
+        prv_inst.stats.export_dropped += msgs;
+        return 0;
+    }
+
+    if (ret == -ENOBUFS) {
+        prv_wear_throttled(msgs);
+        return 0;
+    }
+
+    return ret;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+/** @brief Write the staged bytes as one FCB entry and update savings counters. Mutex must be held. */
+static int prv_staging_flush(void)
+{
+    ovyl_log_storage_staging_t *staging = &prv_inst.staging;
+
+    if (staging->used == 0U) {
+        return 0;
+    }
+
+    int ret = prv_entry_write(staging->buf, staging->used);
+
+    if ((ret == -EAGAIN) || (ret == -ENOBUFS)) {
+        ret = prv_write_dropped(ret, staging->appends);
+    } else if (ret == 0) {
+        uint32_t entries_saved = staging->appends - 1U;
+        uint32_t bytes_saved = staging->entry_overhead - prv_fcb_entry_overhead(staging->used);
+
+        prv_inst.stats.staging_flushes++;
+        prv_inst.stats.staging_last_entries_saved = entries_saved;
+        prv_inst.stats.staging_last_bytes_saved = bytes_saved;
+        prv_inst.stats.staging_entries_saved += entries_saved;
+        prv_inst.stats.staging_bytes_saved += bytes_saved;
+    }
+
+    /* Drop the staged data even on failure so a bad sector cannot wedge logging. */
+    staging->used = 0U;
+    staging->appends = 0U;
+    staging->entry_overhead = 0U;
+
+    return ret;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PAGE_ALIGN
+/**
+ * @brief Largest page-ending payload size for an entry whose length prefix starts at flash offset @p start.
+ *
+ * FCB stores entry lengths below 0x80 in one byte and longer ones in two, so
+ * the prefix size depends on the result; only a consistent pair is returned.
+ *
+ * @return Payload size, or 0 when no consistent size fits @p cap.
+ */
+static size_t prv_staging_fill_at(uint32_t start, uint32_t marker, uint32_t align, size_t cap)
+{
+    for (uint32_t len_bytes = 2U; len_bytes > 0U; len_bytes--) {
+        uint32_t data = start + ROUND_UP(len_bytes, align) + marker;
+        size_t fill = LOG_STORAGE_PROGRAM_PAGE_SIZE - (data % LOG_STORAGE_PROGRAM_PAGE_SIZE);
+
+        while (((fill + LOG_STORAGE_PROGRAM_PAGE_SIZE) <= cap) &&
+               ((len_bytes == 2U) || ((marker + fill + LOG_STORAGE_PROGRAM_PAGE_SIZE) < LOG_STORAGE_FCB_SHORT_LEN_LIMIT))) {
+            fill += LOG_STORAGE_PROGRAM_PAGE_SIZE;
+        }
+
+        if ((fill <= cap) && (((marker + fill) < LOG_STORAGE_FCB_SHORT_LEN_LIMIT) == (len_bytes == 1U))) {
+            return fill;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief Staged payload size at which the entry's data write ends on a program page boundary.
+ *
+ * Accounts for the length prefix and, with the time index, a marker in front
+ * of the data. When the entry would not fit the active sector, it is placed
+ * at the start of the next one. Returns the largest such size that fits the
+ * staging buffer, or the buffer size when no boundary is in reach. Mutex must
+ * be held.
+ */
+static size_t prv_staging_page_fill(void)
+{
+    struct fcb *fcb = &prv_inst.fcb_inst;
+    struct flash_sector *sector = fcb->f_active.fe_sector;
+    uint32_t elem_off = fcb->f_active.fe_elem_off;
+    uint32_t align = MAX(fcb->f_align, 1U);
+    size_t cap = sizeof(prv_inst.staging.buf);
+
+    if (sector == NULL) {
+        return cap;
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        uint32_t marker = 0U;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+        if (!prv_inst.time_index.boot_marked || (elem_off <= prv_fcb_first_elem_off())) {
+            marker = LOG_STORAGE_MARKER_SIZE;
+        }
+#endif
+
+        uint32_t start = (uint32_t)prv_inst.fa->fa_off + sector->fs_off + elem_off;
+        size_t fill = prv_staging_fill_at(start, marker, align, cap);
+
+        if (fill == 0U) {
+            return cap;
+        }
+
+        if ((elem_off + marker + fill + prv_fcb_entry_overhead(fill)) <= sector->fs_size) {
+            return fill;
+        }
+
+        /* The entry will open the next sector. */
+        sector = &prv_inst.sectors[(prv_sector_idx(sector) + 1U) % fcb->f_sector_cnt];
+        elem_off = prv_fcb_first_elem_off();
+    }
+
+    return cap;
+}
+
+/**
+ * @brief Stage data, writing an entry whenever the staged bytes reach a program page boundary.
+ *
+ * Appends are split across entries where needed; readers see one continuous
+ * stream either way. Mutex must be held.
+ */
+static int prv_staging_append(const void *buf, size_t buf_size)
+{
+    ovyl_log_storage_staging_t *staging = &prv_inst.staging;
+    const uint8_t *src = buf;
+    size_t fill;
+
+    while ((staging->used + buf_size) >= (fill = prv_staging_page_fill())) {
+        size_t n = (fill > staging->used) ? (fill - staging->used) : 0U;
+
+        if (n > 0U) {
+            memcpy(&staging->buf[staging->used], src, n);
+            staging->used += n;
+            staging->appends++;
+            staging->entry_overhead += prv_fcb_entry_overhead(n);
+            src += n;
+            buf_size -= n;
+        }
+
+        int ret = prv_staging_flush();
+
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    if (buf_size == 0U) {
+        return 0;
+    }
+
+    memcpy(&staging->buf[staging->used], src, buf_size);
+    staging->used += buf_size;
+    staging->appends++;
+    staging->entry_overhead += prv_fcb_entry_overhead(buf_size);
+
+    if (!k_work_delayable_is_pending(&staging->flush_work)) {
+        k_work_schedule(&staging->flush_work, K_MSEC(CONFIG_OVYL_LOG_STORAGE_STAGING_FLUSH_MS));
+    }
+
+    return 0;
+}
+#else
+/** @brief Copy data into the staging buffer, flushing first when it would overflow. Mutex must be held. */
+static int prv_staging_append(const void *buf, size_t buf_size)
+{
+    ovyl_log_storage_staging_t *staging = &prv_inst.staging;
+    int ret;
+
+    if ((staging->used + buf_size) > sizeof(staging->buf)) {
+        ret = prv_staging_flush();
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    if (buf_size > sizeof(staging->buf)) {
+        return prv_write_dropped(prv_entry_write(buf, buf_size), 1U);
+    }
+
+    memcpy(&staging->buf[staging->used], buf, buf_size);
+    staging->used += buf_size;
+    staging->appends++;
+    staging->entry_overhead += prv_fcb_entry_overhead(buf_size);
+
+    if (!k_work_delayable_is_pending(&staging->flush_work)) {
+        k_work_schedule(&staging->flush_work, K_MSEC(CONFIG_OVYL_LOG_STORAGE_STAGING_FLUSH_MS));
+    }
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_PAGE_ALIGN */
+
+/** @brief Work handler that flushes staged data once the flush interval expires. */
+static void prv_staging_flush_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    if (k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        k_work_schedule(&prv_inst.staging.flush_work,
+                        K_MSEC(CONFIG_OVYL_LOG_STORAGE_STAGING_FLUSH_MS));
+        return;
+    }
+
+    (void)prv_staging_flush();
+
+    k_mutex_unlock(prv_inst.lock);
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_STAGING */
+
+/** @brief Route data to the staging buffer or straight to the FCB. Mutex must be held. */
+static int prv_store(const void *buf, size_t buf_size)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    return prv_staging_append(buf, buf_size);
+#else
+    return prv_write_dropped(prv_entry_write(buf, buf_size), 1U);
+#endif
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+/** @brief Reset the producer ring so it starts out empty. */
+static void prv_ring_init(void)
+{
+    ovyl_log_storage_ring_init(&prv_inst.async.ring);
+    k_sem_init(&prv_inst.async.data_sem, 0, 1);
+}
+
+/**
+ * @brief Queue data as one message for the writer thread, applying the overflow policy.
+ *
+ * A message dropped because the ring is full is counted and reported as consumed so
+ * log_output does not retry it; only a message that can never fit is an error.
+ */
+static int prv_ring_push(const void *buf, size_t buf_size)
+{
+    if (buf_size == 0U) {
+        return 0;
+    }
+
+    int ret = ovyl_log_storage_ring_push(&prv_inst.async.ring, buf, buf_size);
+
+    if (ret == -EMSGSIZE) {
+        return ret;
+    }
+
+    k_sem_give(&prv_inst.async.data_sem);
+
+    return 0;
+}
+
+/** @brief Move the oldest queued message into storage. Mutex must be held. */
+static bool prv_ring_drain_one(void)
+{
+    atomic_val_t pos;
+    uint32_t count;
+
+    if (!ovyl_log_storage_ring_claim(&prv_inst.async.ring, &pos, &count)) {
+        return false;
+    }
+
+    for (uint32_t k = 0; k < count; k++) {
+        ovyl_log_storage_ring_slot_t *slot = ovyl_log_storage_ring_slot(&prv_inst.async.ring, pos + k);
+
+        (void)prv_store(slot->data, slot->len);
+    }
+
+    ovyl_log_storage_ring_release(&prv_inst.async.ring, pos, count);
+    return true;
+}
+
+/** @brief Move every queued message into storage. Mutex must be held. */
+static void prv_ring_drain(void)
+{
+    while (prv_ring_drain_one()) {
+    }
+}
+
+/** @brief Writer thread that drains the producer ring into flash. */
+static void prv_writer_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1) {
+        bool more = true;
+
+        k_sem_take(&prv_inst.async.data_sem, K_FOREVER);
+
+        /* One message per lock hold, so flush and panic never wait behind a whole backlog. */
+        while (more) {
+            if (k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+                k_sem_give(&prv_inst.async.data_sem);
+                k_sleep(K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+                break;
+            }
+
+            more = prv_ring_drain_one();
+
+            k_mutex_unlock(prv_inst.lock);
+        }
+    }
+}
+
+/** @brief Start the writer thread once. */
+static void prv_writer_start(void)
+{
+    if (prv_inst.async.thread_started) {
+        return;
+    }
+
+    k_thread_create(&prv_inst.async.thread,
+                    prv_writer_stack,
+                    K_THREAD_STACK_SIZEOF(prv_writer_stack),
+                    prv_writer_thread,
+                    NULL,
+                    NULL,
+                    NULL,
+                    LOG_STORAGE_WRITER_PRIORITY,
+                    0,
+                    K_NO_WAIT);
+
+    k_thread_name_set(&prv_inst.async.thread, "ovyl_log_writer");
+    prv_inst.async.thread_started = true;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_ASYNC */
+
+/** @brief Push queued ring slots and staged bytes into the FCB. Mutex must be held. */
+static int prv_flush_pending(void)
+{
+    int ret = 0;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    prv_ring_drain();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    ret = prv_staging_flush();
+#endif
+
+    return ret;
+}
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_PANIC_REGION) || defined(CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE)
+/** @brief Check whether appends go to the panic region instead of the FCB. */
+static bool prv_panic_region_active(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    return prv_inst.panic_mode && prv_inst.panic.ready;
+#else
+    return false;
+#endif
+}
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/** @brief Open the panic region with a chunk holding this boot's time marker. */
+static int prv_panic_write_boot(void)
+{
+    ovyl_log_storage_panic_region_t *p = &prv_inst.panic;
+    uint8_t chunk[ROUND_UP(LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + LOG_STORAGE_MARKER_SIZE, LOG_STORAGE_PANIC_ALIGN_MAX)];
+    size_t total = ROUND_UP(LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + LOG_STORAGE_MARKER_SIZE, p->align);
+
+    memset(chunk, 0, sizeof(chunk));
+    sys_put_le16(LOG_STORAGE_PANIC_BOOT_MAGIC, &chunk[0]);
+    sys_put_le16(LOG_STORAGE_MARKER_SIZE, &chunk[2]);
+    prv_marker_build(&chunk[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE]);
+
+    if (total > p->size) {
+        return -ENOSPC;
+    }
+
+    int ret = flash_area_write(prv_inst.fa, p->off, chunk, total);
+
+    p->wr = total;
+    return ret;
+}
+#endif
+
+/** @brief Write the chunk assembled in the panic buffer. Runs without the mutex; only called once panicked. */
+static int prv_panic_flush(void)
+{
+    ovyl_log_storage_panic_region_t *p = &prv_inst.panic;
+    size_t used = LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + p->len;
+    size_t total = ROUND_UP(used, p->align);
+
+    if (p->len == 0U) {
+        return 0;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    if (p->wr == 0U) {
+        /* The next boot files the recovered logs under this boot, not its own. */
+        (void)prv_panic_write_boot();
+    }
+#endif
+
+    sys_put_le16(LOG_STORAGE_PANIC_CHUNK_MAGIC, &p->buf[0]);
+    sys_put_le16((uint16_t)p->len, &p->buf[2]);
+    memset(&p->buf[used], 0, total - used);
+    p->len = 0U;
+
+    if ((p->wr + total) > p->size) {
+        return -ENOSPC;
+    }
+
+    int ret = flash_area_write(prv_inst.fa, p->off + (off_t)p->wr, p->buf, total);
+
+    p->wr += total;
+    return ret;
+}
+
+/** @brief Write data to the panic region right away. Runs without the mutex; only called once panicked. */
+static int prv_panic_write(const uint8_t *data, size_t len)
+{
+    ovyl_log_storage_panic_region_t *p = &prv_inst.panic;
+    int ret = 0;
+
+    while ((len > 0U) && (ret == 0)) {
+        size_t n = MIN(len, LOG_STORAGE_PANIC_CHUNK_SIZE - p->len);
+
+        memcpy(&p->buf[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + p->len], data, n);
+        p->len += n;
+        data += n;
+        len -= n;
+
+        /* Nothing may stay buffered: the next instruction could be the reset. */
+        ret = prv_panic_flush();
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Move data still queued for the FCB into the panic region.
+ *
+ * The thread owning the mutex may be the one that faulted, so the ring and
+ * staging buffer are read as they are, without taking it.
+ */
+static void prv_panic_drain_pending(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    atomic_val_t pos;
+    uint32_t count;
+
+    while (ovyl_log_storage_ring_claim(&prv_inst.async.ring, &pos, &count)) {
+        for (uint32_t k = 0; k < count; k++) {
+            ovyl_log_storage_ring_slot_t *slot = ovyl_log_storage_ring_slot(&prv_inst.async.ring, pos + k);
+
+            (void)prv_panic_write(slot->data, slot->len);
+        }
+        ovyl_log_storage_ring_release(&prv_inst.async.ring, pos, count);
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    (void)prv_panic_write(prv_inst.staging.buf, prv_inst.staging.used);
+    prv_inst.staging.used = 0U;
+#endif
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_PANIC_REGION */
+
+/**
+ * @brief Check whether a filtered export wants the entry at @p loc. Mutex must be held.
+ *
+ * Tracks the boot id through the markers the time index leaves on the first
+ * entry of every sector and of every boot.
+ */
+static bool prv_export_entry_wanted(const struct fcb_entry *loc, uint32_t flags)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    ovyl_log_storage_export_filter_t *f = prv_inst.export_filter;
+    uint64_t key;
+
+    if ((flags & OVYL_LOG_STORAGE_FILTER_BOOT) == 0U) {
+        return true;
+    }
+
+    if (prv_entry_marker_key(loc, &key)) {
+        f->boot = (uint16_t)(key >> 48);
+        f->boot_known = true;
+    }
+
+    return f->boot_known && (f->boot == f->filter->boot);
+#else
+    ARG_UNUSED(loc);
+    ARG_UNUSED(flags);
+
+    return true;
+#endif
+}
+
+/**
+ * @brief Copy the next chunk for a reader and advance its position. Mutex must be held.
+ *
+ * @param ctx Reader position.
+ * @param bounded Stop at the export snapshot end instead of the live tail.
+ */
+static int prv_read_ctx_fetch(ovyl_log_storage_read_ctx_t *ctx,
+                              bool bounded,
+                              void *dst,
+                              size_t dest_size,
+                              size_t *out_size)
+{
+    struct fcb_entry *loc = &ctx->head;
+    size_t entry_len = 0U;
+    int ret;
+
+    if (loc->fe_sector != NULL) {
+        ret = prv_entry_len(loc, &entry_len);
+        if (ret < 0) {
+            LOG_ERR("Failed to read from flash %d", ret);
+            return -EIO;
+        }
+    }
+
+    if (loc->fe_sector == NULL || ctx->read_bytes >= entry_len) {
+        ret = bounded ? prv_snapshot_next(loc) : prv_fcb_getnext(loc);
+
+        if (ret < 0) {
+            return ret;
+        }
+
+        ctx->read_bytes = 0;
+
+        ret = prv_entry_len(loc, &entry_len);
+        if (ret < 0) {
+            LOG_ERR("Failed to read from flash %d", ret);
+            return -EIO;
+        }
+    }
+
+    size_t len = MIN(entry_len - ctx->read_bytes, dest_size);
+
+    ret = prv_entry_read(loc, ctx->read_bytes, dst, len);
+
+    if (ret < 0) {
+        LOG_ERR("Failed to read from flash %d", ret);
+        return -EIO;
+    }
+
+    ctx->read_bytes += len;
+    *out_size = len;
+
+    return 0;
+}
+
+/**
+ * @brief Fill @p dst with as many entries as fit, continuing across entry boundaries. Mutex must be held.
+ *
+ * With OVYL_LOG_STORAGE_BULK_ENTRY_HDR each entry starts with its payload
+ * length; a header is only written when at least one payload byte fits after
+ * it, so the concatenated output of successive calls is a well-formed stream.
+ */
+static int prv_read_ctx_fetch_bulk(ovyl_log_storage_read_ctx_t *ctx,
+                                   bool bounded,
+                                   uint8_t *dst,
+                                   size_t dest_size,
+                                   uint32_t flags,
+                                   size_t *out_size)
+{
+    struct fcb_entry *loc = &ctx->head;
+    bool entry_hdr = (flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR) != 0U;
+    size_t total = 0U;
+    int ret = 0;
+
+    while (total < dest_size) {
+        size_t entry_len = 0U;
+
+        if ((loc->fe_sector != NULL) && (ctx->read_bytes != LOG_STORAGE_ENTRY_SKIPPED)) {
+            ret = prv_entry_len(loc, &entry_len);
+            if (ret < 0) {
+                LOG_ERR("Failed to read from flash %d", ret);
+                return -EIO;
+            }
+        }
+
+        if (loc->fe_sector == NULL || ctx->read_bytes >= entry_len) {
+            ret = bounded ? prv_snapshot_next(loc) : prv_fcb_getnext(loc);
+            if (ret < 0) {
+                break;
+            }
+
+            ctx->read_bytes = prv_export_entry_wanted(loc, flags) ? 0U : LOG_STORAGE_ENTRY_SKIPPED;
+            continue;
+        }
+
+        size_t space = dest_size - total;
+
+        if (entry_hdr && (ctx->read_bytes == 0U)) {
+            if (space <= OVYL_LOG_STORAGE_BULK_HDR_SIZE) {
+                break;
+            }
+
+            sys_put_le16((uint16_t)entry_len, &dst[total]);
+            total += OVYL_LOG_STORAGE_BULK_HDR_SIZE;
+            space -= OVYL_LOG_STORAGE_BULK_HDR_SIZE;
+        }
+
+        size_t len = MIN(entry_len - ctx->read_bytes, space);
+
+        ret = prv_entry_read(loc, ctx->read_bytes, &dst[total], len);
+        if (ret < 0) {
+            LOG_ERR("Failed to read from flash %d", ret);
+            return -EIO;
+        }
+
+        ctx->read_bytes += len;
+        total += len;
+    }
+
+    *out_size = total;
+
+    if ((ret == -ENOENT) && (total > 0U)) {
+        ret = 0;
+    }
+
+    return ret;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+/** @brief Read the next record header of the main log into the merge state. Mutex must be held. */
+static int prv_merge_load_main(ovyl_log_storage_read_ctx_t *ctx, uint32_t flags)
+{
+    ovyl_log_storage_merge_t *m = &prv_inst.merge;
+    uint8_t *raw = m->raw[LOG_STORAGE_LANE_MAIN];
+    size_t have = 0U;
+
+    while (true) {
+        while (have < OVYL_LOG_STORAGE_RECORD_HDR_SIZE) {
+            size_t got = 0U;
+            int ret = prv_read_ctx_fetch_bulk(ctx, true, &raw[have], OVYL_LOG_STORAGE_RECORD_HDR_SIZE - have, flags,
+                                              &got);
+
+            if (ret < 0) {
+                m->done[LOG_STORAGE_LANE_MAIN] = true;
+                return (ret == -ENOENT) ? 0 : ret;
+            }
+
+            have += got;
+        }
+
+        if (ovyl_log_storage_record_hdr_decode(raw, &m->hdr[LOG_STORAGE_LANE_MAIN]) == 0) {
+            m->loaded[LOG_STORAGE_LANE_MAIN] = true;
+            return 0;
+        }
+
+        /* Not at a record boundary (data from before record headers): resynchronize. */
+        memmove(raw, &raw[1], OVYL_LOG_STORAGE_RECORD_HDR_SIZE - 1U);
+        have--;
+    }
+}
+
+/** @brief Read the next wanted record header of the priority lane. Mutex must be held. */
+static int prv_merge_load_lane(uint32_t flags)
+{
+    ovyl_log_storage_merge_t *m = &prv_inst.merge;
+    ovyl_log_storage_record_hdr_t *hdr = &m->hdr[LOG_STORAGE_LANE_PRIO];
+    const ovyl_log_storage_filter_t *filter = prv_inst.export_filter->filter;
+
+    if (m->until && m->done[LOG_STORAGE_LANE_MAIN]) {
+        /* Lane records after the bounded main log are past the --until time. */
+        m->done[LOG_STORAGE_LANE_PRIO] = true;
+        return 0;
+    }
+
+    while (prv_lane_next(&m->lane_loc) == 0) {
+        if (m->lane_loc.fe_data_len < OVYL_LOG_STORAGE_RECORD_HDR_SIZE) {
+            continue;
+        }
+
+        if (prv_flash_read(FCB_ENTRY_FA_DATA_OFF(m->lane_loc), m->raw[LOG_STORAGE_LANE_PRIO],
+                           OVYL_LOG_STORAGE_RECORD_HDR_SIZE) < 0) {
+            return -EIO;
+        }
+
+        if ((ovyl_log_storage_record_hdr_decode(m->raw[LOG_STORAGE_LANE_PRIO], hdr) < 0) ||
+            ((OVYL_LOG_STORAGE_RECORD_HDR_SIZE + hdr->len) > m->lane_loc.fe_data_len)) {
+            continue;
+        }
+
+        if (((flags & OVYL_LOG_STORAGE_FILTER_BOOT) != 0U) && (hdr->boot_id != filter->boot)) {
+            continue;
+        }
+
+        if (m->since && (LOG_STORAGE_RECORD_KEY(*hdr) < m->since_key)) {
+            continue;
+        }
+
+        prv_inst.lane.pin = m->lane_loc.fe_sector;
+        m->loaded[LOG_STORAGE_LANE_PRIO] = true;
+        return 0;
+    }
+
+    m->done[LOG_STORAGE_LANE_PRIO] = true;
+    return 0;
+}
+
+/**
+ * @brief Start merging the main log and the priority lane for an export. Mutex must be held.
+ *
+ * @param ctx Main log export position, already placed by any --since seek.
+ */
+static int prv_merge_begin(ovyl_log_storage_read_ctx_t *ctx, uint32_t flags)
+{
+    ovyl_log_storage_merge_t *m = &prv_inst.merge;
+
+    memset(m, 0, sizeof(*m));
+    m->cur = -1;
+    m->until = (flags & OVYL_LOG_STORAGE_FILTER_UNTIL) != 0U;
+
+    prv_inst.lane.end = prv_inst.lane.fcb.f_active;
+    prv_inst.lane.pin = prv_inst.lane.fcb.f_oldest;
+
+    int ret = prv_merge_load_main(ctx, flags);
+
+    if ((ret == 0) && ((flags & OVYL_LOG_STORAGE_FILTER_SINCE) != 0U)) {
+        m->since = true;
+        m->since_key = m->loaded[LOG_STORAGE_LANE_MAIN] ? LOG_STORAGE_RECORD_KEY(m->hdr[LOG_STORAGE_LANE_MAIN])
+                                                        : UINT64_MAX;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Fill @p dst with whole records from both lanes in (boot, sequence) order. Mutex must be held.
+ *
+ * @retval 0 Data was copied.
+ * @retval -ENOENT Both lanes are exhausted.
+ */
+static int prv_merge_fetch(ovyl_log_storage_read_ctx_t *ctx,
+                           uint8_t *dst,
+                           size_t dest_size,
+                           uint32_t flags,
+                           size_t *out_size)
+{
+    ovyl_log_storage_merge_t *m = &prv_inst.merge;
+    size_t total = 0U;
+    int ret = 0;
+
+    while (total < dest_size) {
+        size_t space = dest_size - total;
+
+        if (m->cur < 0) {
+            if (!m->loaded[LOG_STORAGE_LANE_MAIN] && !m->done[LOG_STORAGE_LANE_MAIN]) {
+                ret = prv_merge_load_main(ctx, flags);
+            }
+
+            if ((ret == 0) && !m->loaded[LOG_STORAGE_LANE_PRIO] && !m->done[LOG_STORAGE_LANE_PRIO]) {
+                ret = prv_merge_load_lane(flags);
+            }
+
+            if (ret < 0) {
+                return ret;
+            }
+
+            if (m->loaded[LOG_STORAGE_LANE_MAIN] && m->loaded[LOG_STORAGE_LANE_PRIO]) {
+                m->cur = (LOG_STORAGE_RECORD_KEY(m->hdr[LOG_STORAGE_LANE_PRIO]) <
+                          LOG_STORAGE_RECORD_KEY(m->hdr[LOG_STORAGE_LANE_MAIN]))
+                             ? LOG_STORAGE_LANE_PRIO
+                             : LOG_STORAGE_LANE_MAIN;
+            } else if (m->loaded[LOG_STORAGE_LANE_MAIN]) {
+                m->cur = LOG_STORAGE_LANE_MAIN;
+            } else if (m->loaded[LOG_STORAGE_LANE_PRIO]) {
+                m->cur = LOG_STORAGE_LANE_PRIO;
+            } else {
+                break;
+            }
+
+            m->hdr_pos = 0U;
+            m->payload_pos = 0U;
+        }
+
+        ovyl_log_storage_record_hdr_t *hdr = &m->hdr[m->cur];
+
+        if (m->hdr_pos < OVYL_LOG_STORAGE_RECORD_HDR_SIZE) {
+            size_t len = MIN(OVYL_LOG_STORAGE_RECORD_HDR_SIZE - m->hdr_pos, space);
+
+            memcpy(&dst[total], &m->raw[m->cur][m->hdr_pos], len);
+            m->hdr_pos += len;
+            total += len;
+            continue;
+        }
+
+        if (m->payload_pos < hdr->len) {
+            size_t len = MIN((size_t)hdr->len - m->payload_pos, space);
+
+            if (m->cur == LOG_STORAGE_LANE_MAIN) {
+                ret = prv_read_ctx_fetch_bulk(ctx, true, &dst[total], len, flags, &len);
+
+                if (ret < 0) {
+                    /* The main log ended inside this record; nothing more follows it. */
+                    m->done[LOG_STORAGE_LANE_MAIN] = true;
+                    m->payload_pos = hdr->len;
+                    ret = 0;
+                    continue;
+                }
+            } else {
+                ret = prv_flash_read(FCB_ENTRY_FA_DATA_OFF(m->lane_loc) + OVYL_LOG_STORAGE_RECORD_HDR_SIZE +
+                                         m->payload_pos,
+                                     &dst[total],
+                                     len);
+                if (ret < 0) {
+                    return -EIO;
+                }
+            }
+
+            m->payload_pos += len;
+            total += len;
+            continue;
+        }
+
+        m->loaded[m->cur] = false;
+        m->cur = -1;
+    }
+
+    *out_size = total;
+    return (total > 0U) ? 0 : -ENOENT;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+/** @brief Restore the upload position from the persisted watermark, or start from the oldest entry. */
+static void prv_upload_load(void)
+{
+    ovyl_log_storage_upload_t *up = &prv_inst.upload;
+    ovyl_log_storage_position_t pos;
+    struct flash_sector *sector;
+
+    memset(up, 0, sizeof(*up));
+
+    if (!ovyl_config_mgr_get_value(CFG_LOG_STORAGE_WATERMARK, &pos, sizeof(pos))) {
+        return;
+    }
+
+    if (prv_position_resolve(&pos, &sector) < 0) {
+        LOG_DBG("Upload watermark no longer stored; uploading from oldest entry");
+        return;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if (prv_floor_hides(sector, pos.elem_off)) {
+        LOG_DBG("Upload watermark predates the last clear; uploading from oldest entry");
+        return;
+    }
+#endif
+
+    up->acked.fe_sector = sector;
+    up->acked.fe_elem_off = pos.elem_off;
+    up->ctx.head = up->acked;
+    up->resume = true;
+}
+
+/** @brief Persist a watermark position through Ovyl Config. Called without the mutex held. */
+static int prv_upload_persist(const ovyl_log_storage_position_t *pos)
+{
+    if (!ovyl_config_mgr_set_value(CFG_LOG_STORAGE_WATERMARK, pos, sizeof(*pos))) {
+        LOG_WRN("Failed to persist upload watermark");
+        return -EIO;
+    }
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WATERMARK */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+/** @brief Restore the position of the last logical clear, if its sector is still stored. */
+static void prv_floor_load(void)
+{
+    ovyl_log_storage_position_t pos;
+    struct flash_sector *sector;
+
+    memset(&prv_inst.floor, 0, sizeof(prv_inst.floor));
+
+    if (!ovyl_config_mgr_get_value(CFG_LOG_STORAGE_CLEAR_FLOOR, &pos, sizeof(pos))) {
+        return;
+    }
+
+    /* A stale position means the cleared sectors were rotated out already. */
+    if (prv_position_resolve(&pos, &sector) == 0) {
+        prv_inst.floor.sector = sector;
+        prv_inst.floor.elem_off = pos.elem_off;
+    }
+}
+
+/**
+ * @brief Hide every stored entry by moving the floor to the write position. Mutex must be held.
+ *
+ * @param pos Populated with the new floor for persisting.
+ */
+static int prv_floor_raise(ovyl_log_storage_position_t *pos)
+{
+    struct fcb_entry *active = &prv_inst.fcb_inst.f_active;
+    int ret = prv_position_capture(active->fe_sector, active->fe_elem_off, pos);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    prv_inst.floor.sector = active->fe_sector;
+    prv_inst.floor.elem_off = active->fe_elem_off;
+
+    prv_cursors_drop_sector(NULL);
+    prv_invalidate_entry_cache();
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/**
+ * @brief Read the time key of the boot that panicked from the head of the panic region.
+ *
+ * A boot that crashed before reaching the FCB left no marker for the index
+ * rebuild, so this boot's id is moved past it. Mutex must be held.
+ *
+ * @return Key of the crashed boot, or LOG_STORAGE_TIME_KEY_NONE if the region has none.
+ */
+static uint64_t prv_panic_recover_boot(void)
+{
+    ovyl_log_storage_panic_region_t *p = &prv_inst.panic;
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    uint8_t chunk[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + LOG_STORAGE_MARKER_SIZE];
+    const uint8_t *marker = &chunk[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE];
+
+    if ((p->size < sizeof(chunk)) || (flash_area_read(prv_inst.fa, p->off, chunk, sizeof(chunk)) < 0) ||
+        (sys_get_le16(&chunk[0]) != LOG_STORAGE_PANIC_BOOT_MAGIC) ||
+        (sys_get_le16(&chunk[2]) != LOG_STORAGE_MARKER_SIZE) ||
+        (sys_get_le32(marker) != LOG_STORAGE_MARKER_MAGIC)) {
+        return LOG_STORAGE_TIME_KEY_NONE;
+    }
+
+    uint16_t boot_id = sys_get_le16(&marker[4]);
+
+    if ((int16_t)(ti->boot_id - boot_id) <= 0) {
+        ti->boot_id = boot_id + 1U;
+        ti->boot_marked = false;
+    }
+
+    return LOG_STORAGE_TIME_KEY(boot_id, sys_get_le64(&marker[8]));
+}
+#endif
+
+/**
+ * @brief Copy the chunks left by a panic into the main log and erase the region for the next one.
+ *
+ * Runs at the end of init, so the copied data lands in the log like any other
+ * append and is part of every later export. The region is only erased once
+ * the copy has reached flash; otherwise it is kept for the next boot to retry.
+ */
+static void prv_panic_recover(void)
+{
+    ovyl_log_storage_panic_region_t *p = &prv_inst.panic;
+    uint8_t erased = flash_area_erased_val(prv_inst.fa);
+    uint32_t recovered = 0U;
+    bool dirty = false;
+    int ret;
+
+    p->align = MAX(flash_area_align(prv_inst.fa), 1U);
+    p->wr = 0U;
+    p->len = 0U;
+    p->ready = false;
+
+    if (p->align > LOG_STORAGE_PANIC_ALIGN_MAX) {
+        LOG_ERR("Flash write block too large for the panic region");
+        return;
+    }
+
+    k_mutex_lock(prv_inst.lock, K_FOREVER);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    uint64_t boot_key = prv_panic_recover_boot();
+#endif
+
+    /* Data this boot already queued goes out first, under this boot's marker. */
+    ret = prv_flush_pending();
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    prv_inst.time_index.recover_key = boot_key;
+    prv_inst.time_index.boot_marked = false;
+#endif
+
+    while ((ret == 0) && ((p->wr + LOG_STORAGE_PANIC_CHUNK_HDR_SIZE) <= p->size)) {
+        uint8_t *hdr = p->buf;
+
+        if (flash_area_read(prv_inst.fa, p->off + (off_t)p->wr, hdr, LOG_STORAGE_PANIC_CHUNK_HDR_SIZE) < 0) {
+            dirty = true;
+            break;
+        }
+
+        if ((hdr[0] == erased) && (hdr[1] == erased) && (hdr[2] == erased) && (hdr[3] == erased)) {
+            break;
+        }
+
+        uint16_t magic = sys_get_le16(&hdr[0]);
+        uint16_t len = sys_get_le16(&hdr[2]);
+        size_t total = ROUND_UP(LOG_STORAGE_PANIC_CHUNK_HDR_SIZE + len, p->align);
+
+        /* Anything but a complete chunk is foreign data or a write cut short by the crash. */
+        dirty = true;
+        if (((magic != LOG_STORAGE_PANIC_CHUNK_MAGIC) && (magic != LOG_STORAGE_PANIC_BOOT_MAGIC)) ||
+            (len > LOG_STORAGE_PANIC_CHUNK_SIZE) || ((p->wr + total) > p->size) ||
+            (flash_area_read(prv_inst.fa, p->off + (off_t)p->wr + LOG_STORAGE_PANIC_CHUNK_HDR_SIZE,
+                             &p->buf[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE],
+                             len) < 0)) {
+            break;
+        }
+
+        /* The boot chunk was consumed by prv_panic_recover_boot() before the copy started. */
+        if (magic == LOG_STORAGE_PANIC_CHUNK_MAGIC) {
+            ret = prv_store(&p->buf[LOG_STORAGE_PANIC_CHUNK_HDR_SIZE], len);
+            recovered += len;
+        }
+        p->wr += total;
+    }
+
+    if (ret == 0) {
+        ret = prv_flush_pending();
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    /* The next append is re-marked with this boot's own key. */
+    prv_inst.time_index.recover_key = LOG_STORAGE_TIME_KEY_NONE;
+    prv_inst.time_index.boot_marked = false;
+#endif
+
+    k_mutex_unlock(prv_inst.lock);
+
+    p->wr = 0U;
+
+    if (ret < 0) {
+        /* The region stays out of use until a later boot has copied it out. */
+        LOG_ERR("Failed to copy panic logs (%d), keeping them for the next boot", ret);
+        return;
+    }
+
+    if (dirty) {
+        if (flash_area_erase(prv_inst.fa, p->off, p->size) < 0) {
+            LOG_ERR("Failed to erase panic region");
+            return;
+        }
+
+        prv_wear_count_erase(&prv_inst.sectors[p->first_sector], LOG_STORAGE_PANIC_SECTORS);
+    }
+
+    if (recovered > 0U) {
+        LOG_INF("Recovered %u bytes of panic logs", recovered);
+    }
+
+    prv_inst.stats.panic_recovered = recovered;
+    p->ready = true;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_PANIC_REGION */
+
+/**
+ * @brief Build the FCB sector table from the partition's flash pages.
+ *
+ * Consecutive pages are merged until a sector reaches
+ * CONFIG_OVYL_LOG_STORAGE_MIN_SECTOR_SIZE, or a larger size when the partition
+ * would otherwise need more sectors than the table holds. Pages may differ in
+ * size; the last sector may end up smaller than the others.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL The partition does not start and end on page boundaries.
+ * @retval -ENODEV The partition has no flash device.
+ */
+static int prv_sectors_layout(uint32_t *sector_count)
+{
+    const struct flash_area *fa = prv_inst.fa;
+    const struct device *dev = flash_area_get_device(fa);
+    size_t target = MAX(LOG_STORAGE_MIN_SECTOR_SIZE, DIV_ROUND_UP(fa->fa_size, LOG_STORAGE_NUM_SECTORS));
+    uint32_t cnt = 0U;
+    uint32_t pages = 0U;
+    size_t off = 0U;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    while (off < fa->fa_size) {
+        struct flash_pages_info info;
+        int ret = flash_get_page_info_by_offs(dev, fa->fa_off + (off_t)off, &info);
+
+        if (ret < 0) {
+            return ret;
+        }
+
+        if ((info.start_offset != (fa->fa_off + (off_t)off)) || (info.size > (fa->fa_size - off))) {
+            LOG_ERR("Partition is not aligned to flash pages at offset 0x%x", (uint32_t)off);
+            return -EINVAL;
+        }
+
+        if ((cnt == 0U) || (prv_inst.sectors[cnt - 1U].fs_size >= target)) {
+            if (cnt == ARRAY_SIZE(prv_inst.sectors)) {
+                return -E2BIG;
+            }
+
+            prv_inst.sectors[cnt].fs_off = (off_t)off;
+            prv_inst.sectors[cnt].fs_size = 0U;
+            cnt++;
+        }
+
+        prv_inst.sectors[cnt - 1U].fs_size += info.size;
+        off += info.size;
+        pages++;
+    }
+
+    LOG_INF("%u flash pages grouped into %u sectors of at least %u bytes", pages, cnt, (uint32_t)target);
+
+    /*
+     * Merged sectors fold their size into the sector magics, so fcb_init() rejects logs
+     * written with another grouping instead of reading them with the wrong geometry.
+     * One page per sector keeps the magics of earlier releases.
+     */
+    prv_inst.layout_tag = (cnt == pages) ? 0U : ((uint32_t)target * LOG_STORAGE_LAYOUT_MIX);
+
+    *sector_count = cnt;
+    return 0;
+}
+
+/**
+ * @brief Mount the main log on its @p sector_count sectors, clearing logs of another layout.
+ *
+ * fcb_init() reports -ENOMSG for a sector header with a foreign magic: logs
+ * written with another page grouping or compression setting, or sectors the
+ * priority lane used before it shrank. Only the main log's sectors are then
+ * erased; the lane reformats itself and the panic region may still hold an
+ * unrecovered crash. Persisted positions are invalidated, as they point into
+ * the old layout.
+ */
+static int prv_fcb_mount(uint32_t sector_count)
+{
+    const struct flash_sector *last = &prv_inst.sectors[sector_count - 1U];
+    int ret = 0;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        memset(&prv_inst.fcb_inst, 0, sizeof(prv_inst.fcb_inst));
+        prv_inst.fcb_inst.f_magic = LOG_STORAGE_FCB_MAGIC ^ prv_inst.layout_tag;
+        prv_inst.fcb_inst.f_sectors = prv_inst.sectors;
+        prv_inst.fcb_inst.f_sector_cnt = (uint8_t)sector_count;
+        prv_inst.fcb_inst.f_scratch_cnt = 1U;
+
+        ret = fcb_init(LOG_STORAGE_FLASH_AREA_ID, &prv_inst.fcb_inst);
+        if (ret != -ENOMSG) {
+            break;
+        }
+
+        LOG_WRN("Stored logs use another sector layout or format; clearing them");
+
+        ret = flash_area_erase(prv_inst.fa, 0, (size_t)last->fs_off + last->fs_size);
+        if (ret < 0) {
+            break;
+        }
+
+        prv_wear_count_erase(prv_inst.sectors, sector_count);
+
+        /* A fresh FCB can reuse sector ids, so old positions could still match its headers. */
+#if defined(CONFIG_OVYL_LOG_STORAGE_WATERMARK) || defined(CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR)
+        ovyl_log_storage_position_t none = {.sector_idx = UINT8_MAX};
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+        (void)ovyl_config_mgr_set_value(CFG_LOG_STORAGE_WATERMARK, &none, sizeof(none));
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+        (void)ovyl_config_mgr_set_value(CFG_LOG_STORAGE_CLEAR_FLOOR, &none, sizeof(none));
+#endif
+#endif
+    }
+
+    return ret;
+}
+
+/** @brief Mount the sector table, the main log, the lane and the panic region, then start the features on top. */
+static int prv_fcb_init(struct k_mutex *lock)
+{
+    if (prv_inst.fa != NULL) {
+        return 0;
+    }
+
+    int ret = flash_area_open(LOG_STORAGE_FLASH_AREA_ID, &prv_inst.fa);
+
+    if (ret < 0) {
+        LOG_ERR("Failed to open flash area (ID %d): %d", LOG_STORAGE_FLASH_AREA_ID, ret);
+        return ret;
+    }
+
+    uint32_t sector_count;
+
+    ret = prv_sectors_layout(&sector_count);
+    if (ret < 0) {
+        LOG_ERR("Failed to build the sector table: %d", ret);
+        flash_area_close(prv_inst.fa);
+        prv_inst.fa = NULL;
+        return ret;
+    }
+
+    prv_inst.lock = lock;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    prv_wear_load(sector_count);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    if (sector_count < (LOG_STORAGE_PANIC_SECTORS + 2U)) {
+        LOG_ERR("Partition too small for the panic region");
+        flash_area_close(prv_inst.fa);
+        prv_inst.fa = NULL;
+        return -ENOSPC;
+    }
+
+    /* The panic region takes the last sectors, after the priority lane. */
+    sector_count -= LOG_STORAGE_PANIC_SECTORS;
+    prv_inst.panic.first_sector = sector_count;
+    prv_inst.panic.off = prv_inst.sectors[sector_count].fs_off;
+    prv_inst.panic.size = prv_inst.fa->fa_size - (size_t)prv_inst.panic.off;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if (sector_count < (LOG_STORAGE_LANE_SECTORS + 2U)) {
+        LOG_ERR("Partition too small for the priority lane");
+        flash_area_close(prv_inst.fa);
+        prv_inst.fa = NULL;
+        return -ENOSPC;
+    }
+
+    /* The main log keeps the leading sectors; the lane takes the tail of the partition. */
+    sector_count -= LOG_STORAGE_LANE_SECTORS;
+#endif
+
+    ret = prv_fcb_mount(sector_count);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if ((ret == 0) && (prv_lane_init(sector_count) < 0)) {
+        /* Keep logging to the main log; high-severity records fall back to it. */
+        LOG_ERR("Failed to initialize priority lane");
+    }
+#endif
+
+    if (ret < 0) {
+        LOG_ERR("Failed to initialize FCB: %d", ret);
+        flash_area_close(prv_inst.fa);
+        prv_inst.fa = NULL;
+        return ret;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    prv_floor_load();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    prv_inst.staging.used = 0U;
+    prv_inst.staging.appends = 0U;
+    prv_inst.staging.entry_overhead = 0U;
+    k_work_init_delayable(&prv_inst.staging.flush_work, prv_staging_flush_work_handler);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    k_work_init(&prv_inst.erase_ahead_work, prv_erase_ahead_work_handler);
+    prv_inst.erase_ahead_enabled = true;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    /* Before the writer starts, so no append lands while the index is half built. */
+    k_mutex_lock(prv_inst.lock, K_FOREVER);
+    prv_time_index_rebuild();
+    k_mutex_unlock(prv_inst.lock);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    prv_ring_init();
+    prv_writer_start();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+    prv_upload_load();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    prv_wear_start();
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    prv_panic_recover();
+#endif
+
+    return 0;
+}
+
+/** @brief Store formatted log output in the panic region, the producer ring or the main log. */
+static int prv_fcb_append(const void *buf, size_t buf_size)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    if (prv_panic_region_active()) {
+        return prv_panic_write(buf, buf_size);
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    if (!prv_inst.panic_mode) {
+        return prv_ring_push(buf, buf_size);
+    }
+#endif
+
+    int ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+
+    if (ret < 0) {
+        if (!prv_inst.snapshot.active) {
+            LOG_WRN("Failed to lock mutex.");
+        }
+        return -EBUSY;
+    }
+
+    ret = prv_store(buf, buf_size);
+
+    k_mutex_unlock(prv_inst.lock);
+    return ret;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+/** @brief Encode a record header and store the record, high-severity ones in the priority lane. */
+static int prv_fcb_append_record(const ovyl_log_storage_record_hdr_t *hdr, uint8_t *record, size_t payload_len)
+{
+    /* A continuation repeats the sequence number of the record it extends. */
+    uint32_t seq = ((hdr->flags & OVYL_LOG_STORAGE_RECORD_CONT) != 0U)
+                       ? (uint32_t)atomic_get(&prv_inst.record_seq) - 1U
+                       : (uint32_t)atomic_inc(&prv_inst.record_seq);
+
+    record[0] = OVYL_LOG_STORAGE_RECORD_SYNC;
+    record[1] = (uint8_t)((hdr->level & 0x07U) | (hdr->flags << 3));
+    sys_put_le16(hdr->source_id, &record[2]);
+    sys_put_le16(prv_inst.time_index.boot_id, &record[4]);
+    sys_put_le16((uint16_t)payload_len, &record[6]);
+    sys_put_le32(seq, &record[8]);
+    sys_put_le64(hdr->timestamp, &record[12]);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if ((hdr->level >= LOG_LEVEL_ERR) && (hdr->level <= CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE_LEVEL) &&
+        prv_inst.lane.ready && !prv_panic_region_active()) {
+        /* High-severity records bypass staging and the writer thread; they are rare and must survive. */
+        int ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+
+        if (ret < 0) {
+            return -EBUSY;
+        }
+
+        ret = prv_lane_append(record, OVYL_LOG_STORAGE_RECORD_HDR_SIZE + payload_len);
+        k_mutex_unlock(prv_inst.lock);
+
+        if (ret != -ENODEV) {
+            return ret;
+        }
+    }
+#endif
+
+    return prv_fcb_append(record, OVYL_LOG_STORAGE_RECORD_HDR_SIZE + payload_len);
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_RECORD_HDR */
+
+/** @brief Write out staged and queued data, or the panic chunk once the region is active. */
+static int prv_fcb_flush(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    if (prv_panic_region_active()) {
+        return prv_panic_flush();
+    }
+#endif
+
+    int ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    ret = prv_flush_pending();
+
+    k_mutex_unlock(prv_inst.lock);
+    return ret;
+}
+
+/** @brief Switch to panic mode and write out everything still buffered. */
+static int prv_fcb_panic(void)
+{
+    prv_inst.panic_mode = true;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    if (prv_inst.panic.ready) {
+        /* Fault context: never wait for the mutex, its owner may be the thread that crashed. */
+        prv_panic_drain_pending();
+        return prv_panic_flush();
+    }
+#endif
+
+    return prv_fcb_flush();
+}
+
+/** @brief Report the sector and entry offset a reader is at. */
+static int prv_fcb_position(const ovyl_log_storage_read_ctx_t *ctx, uint32_t *unit, uint32_t *offset)
+{
+    if (ctx->head.fe_sector == NULL) {
+        return -ENOENT;
+    }
+
+    *unit = (uint32_t)(ctx->head.fe_sector - prv_inst.sectors);
+    *offset = ctx->head.fe_elem_off;
+    return 0;
+}
+
+/** @brief Pin the oldest sector again after the read head was rewound. Mutex must be held. */
+static void prv_snapshot_rewind(void)
+{
+    if (prv_inst.snapshot.active) {
+        prv_inst.snapshot.pin = prv_inst.fcb_inst.f_oldest;
+    }
+}
+
+/**
+ * @brief Apply the time and boot filters to the export reader and start the lane merge. Mutex must be held.
+ *
+ * @retval -ENOTSUP Time or boot filter without the time index.
+ * @retval -EINVAL Bulk entry headers together with the priority lane.
+ */
+static int prv_fcb_export_begin(ovyl_log_storage_read_ctx_t *ctx, ovyl_log_storage_export_filter_t *f)
+{
+    const ovyl_log_storage_filter_t *filter = f->filter;
+
+#ifndef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    if ((filter->flags & (OVYL_LOG_STORAGE_FILTER_SINCE | OVYL_LOG_STORAGE_FILTER_UNTIL |
+                          OVYL_LOG_STORAGE_FILTER_BOOT)) != 0U) {
+        return -ENOTSUP;
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if ((filter->flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR) != 0U) {
+        /* Merged records no longer line up with main-log entries. */
+        return -EINVAL;
+    }
+#endif
+
+    prv_inst.export_filter = f;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    bool since = (filter->flags & OVYL_LOG_STORAGE_FILTER_SINCE) != 0U;
+    bool boot = (filter->flags & OVYL_LOG_STORAGE_FILTER_BOOT) != 0U;
+    uint64_t since_key = LOG_STORAGE_TIME_KEY(filter->since_boot, filter->since_ms);
+
+    if ((filter->flags & OVYL_LOG_STORAGE_FILTER_UNTIL) != 0U) {
+        prv_inst.snapshot.until = LOG_STORAGE_TIME_KEY(filter->until_boot, filter->until_ms);
+    } else if (boot) {
+        prv_inst.snapshot.until = LOG_STORAGE_TIME_KEY(filter->boot, BIT64_MASK(48));
+    }
+
+    if (!since && boot) {
+        /* Skip straight to the sector where the requested boot starts. */
+        since_key = LOG_STORAGE_TIME_KEY(filter->boot, 0U);
+        since = true;
+    }
+
+    if (since && (prv_time_index_seek(since_key, &ctx->head) == 0)) {
+        prv_inst.snapshot.pin = ctx->head.fe_sector;
+        ctx->read_bytes = prv_export_entry_wanted(&ctx->head, filter->flags) ? 0U : LOG_STORAGE_ENTRY_SKIPPED;
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if (prv_inst.lane.ready) {
+        return prv_merge_begin(ctx, filter->flags);
+    }
+#endif
+
+    return 0;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+/** @brief Read the next export chunk, merged with the priority lane when it is in use. Mutex must be held. */
+static int prv_fcb_export_read(ovyl_log_storage_read_ctx_t *ctx,
+                               uint8_t *dst,
+                               size_t dest_size,
+                               uint32_t flags,
+                               size_t *out_size)
+{
+    if (prv_inst.lane.ready) {
+        return prv_merge_fetch(ctx, dst, dest_size, flags, out_size);
+    }
+
+    return prv_read_ctx_fetch_bulk(ctx, true, dst, dest_size, flags, out_size);
+}
+#endif
+
+/** @brief Erase (or, with lazy clear, hide) the main log and erase the priority lane. Mutex must be held. */
+static int prv_fcb_clear_logs(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    ovyl_log_storage_position_t floor_pos;
+    int ret = prv_floor_raise(&floor_pos);
+#else
+    int ret = prv_fcb_clear();
+#endif
+    if (ret < 0) {
+        LOG_ERR("Failed to clear FCB: %d", ret);
+        return ret;
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    if (prv_inst.lane.ready) {
+        prv_wear_count_clear(&prv_inst.lane.fcb);
+    }
+
+    if (prv_inst.lane.ready && (fcb_clear(&prv_inst.lane.fcb) < 0)) {
+        LOG_ERR("Failed to clear priority lane");
+    }
+
+    prv_inst.lane.end = prv_inst.lane.fcb.f_active;
+    prv_inst.merge.done[LOG_STORAGE_LANE_PRIO] = true;
+#endif
+
+    if (prv_inst.snapshot.active) {
+        /* Nothing left to export; later reads stop immediately. */
+        prv_inst.snapshot.end = prv_inst.fcb_inst.f_active;
+        prv_inst.snapshot.pin = prv_visible_oldest();
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    prv_inst.staging.used = 0U;
+    prv_inst.staging.appends = 0U;
+    prv_inst.staging.entry_overhead = 0U;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    atomic_val_t pos;
+    uint32_t count;
+
+    while (ovyl_log_storage_ring_claim(&prv_inst.async.ring, &pos, &count)) {
+        ovyl_log_storage_ring_release(&prv_inst.async.ring, pos, count);
+    }
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    if (!ovyl_config_mgr_set_value(CFG_LOG_STORAGE_CLEAR_FLOOR, &floor_pos, sizeof(floor_pos))) {
+        LOG_WRN("Failed to persist clear position; cleared logs reappear after reboot");
+        return -EIO;
+    }
+#endif
+
+    return 0;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+/** @brief Place a reader at the sector holding a point in time. Mutex must be held. */
+static int prv_fcb_seek_time(ovyl_log_storage_read_ctx_t *ctx, uint16_t boot_id, uint64_t uptime_ms)
+{
+    struct fcb_entry loc;
+    int ret = prv_time_index_seek(LOG_STORAGE_TIME_KEY(boot_id, uptime_ms), &loc);
+
+    if (ret == 0) {
+        ctx->head = loc;
+        ctx->read_bytes = 0U;
+
+        if (prv_inst.snapshot.active) {
+            prv_inst.snapshot.pin = loc.fe_sector;
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Report the boot id the time index assigned to this boot. */
+static uint16_t prv_fcb_boot_id(void)
+{
+    return prv_inst.time_index.boot_id;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_TIME_INDEX */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+/** @brief Fetch the next unacknowledged bytes and track fully delivered entries. Mutex must be held. */
+static int prv_fcb_upload_fetch(void *dst, size_t dest_size, size_t *out_size)
+{
+    ovyl_log_storage_upload_t *up = &prv_inst.upload;
+    struct fcb_entry prev = up->ctx.head;
+    int ret;
+
+    if (up->resume) {
+        ret = prv_fcb_getnext(&up->ctx.head);
+        if (ret < 0) {
+            return ret;
+        }
+
+        up->resume = false;
+        up->ctx.read_bytes = 0U;
+        prev.fe_sector = NULL;
+    }
+
+    ret = prv_read_ctx_fetch(&up->ctx, false, dst, dest_size, out_size);
+
+    if (ret == 0) {
+        /* Moving on to a new entry means the previous one was handed out completely. */
+        if ((prev.fe_sector != NULL) && ((prev.fe_sector != up->ctx.head.fe_sector) ||
+                                         (prev.fe_elem_off != up->ctx.head.fe_elem_off))) {
+            up->delivered = prev;
+        }
+    } else if ((ret == -ENOENT) && (up->ctx.head.fe_sector != NULL)) {
+        up->delivered = up->ctx.head;
+    }
+
+    return ret;
+}
+
+/** @brief Move the watermark to the last delivered entry and persist it. Mutex must be held. */
+static int prv_fcb_upload_ack(void)
+{
+    ovyl_log_storage_upload_t *up = &prv_inst.upload;
+    ovyl_log_storage_position_t pos;
+
+    if ((up->delivered.fe_sector == NULL) || ((up->delivered.fe_sector == up->acked.fe_sector) &&
+                                              (up->delivered.fe_elem_off == up->acked.fe_elem_off))) {
+        return 0;
+    }
+
+    int ret = prv_position_capture(up->delivered.fe_sector, up->delivered.fe_elem_off, &pos);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    up->acked = up->delivered;
+
+    return prv_upload_persist(&pos);
+}
+
+/** @brief Restart the upload after the acknowledged entry. Mutex must be held. */
+static int prv_fcb_upload_rewind(void)
+{
+    ovyl_log_storage_upload_t *up = &prv_inst.upload;
+
+    memset(&up->ctx, 0, sizeof(up->ctx));
+    up->ctx.head = up->acked;
+    up->delivered = up->acked;
+    up->resume = (up->acked.fe_sector != NULL);
+
+    return 0;
+}
+
+/** @brief Forget the watermark so the next upload starts at the oldest entry. Mutex must be held. */
+static int prv_fcb_upload_reset(void)
+{
+    ovyl_log_storage_position_t pos = {.sector_idx = UINT8_MAX};
+
+    memset(&prv_inst.upload, 0, sizeof(prv_inst.upload));
+
+    return prv_upload_persist(&pos);
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WATERMARK */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+/** @brief Enable or disable background sector pre-erase. */
+static int prv_fcb_set_erase_ahead(bool enable)
+{
+    prv_inst.erase_ahead_enabled = enable;
+
+    if (enable) {
+        k_work_submit(&prv_inst.erase_ahead_work);
+    }
+
+    return 0;
+}
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+/** @brief Most verbose level the write-budget governor currently lets through. */
+static uint8_t prv_fcb_wear_level(void)
+{
+    if ((prv_inst.wear.state == OVYL_LOG_STORAGE_WEAR_THROTTLED) && !prv_inst.panic_mode) {
+        return LOG_LEVEL_NONE;
+    }
+
+    if (prv_inst.wear.state != OVYL_LOG_STORAGE_WEAR_NORMAL) {
+        return CONFIG_OVYL_LOG_STORAGE_WEAR_LEVEL;
+    }
+
+    return LOG_LEVEL_DBG;
+}
+
+/** @brief Report wear counters and the governor state. Mutex must be held. */
+static int prv_fcb_get_wear(ovyl_log_storage_wear_status_t *status)
+{
+    ovyl_log_storage_governor_t *g = &prv_inst.wear;
+
+    prv_wear_roll();
+    prv_wear_minutes_update();
+
+    status->state = g->state;
+    status->level = prv_fcb_wear_level();
+    status->minutes = g->rec.minutes;
+    status->bytes = g->rec.bytes;
+    status->hour_bytes = g->hour_bytes;
+    status->last_hour_bytes = g->last_hour_bytes;
+    status->budget_per_hour = g->budget_per_hour;
+    status->max_erases = g->max_erases;
+    status->throttled = g->throttled;
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WEAR */
+
+/** @brief Copy the backend counters, including those kept outside the stats structure. Mutex must be held. */
+static void prv_fcb_get_stats(ovyl_log_storage_stats_t *stats)
+{
+    *stats = prv_inst.stats;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    stats->compress_us = (uint32_t)k_cyc_to_us_floor64(prv_inst.compress.encode_cycles);
+    stats->decompress_us = (uint32_t)k_cyc_to_us_floor64(prv_inst.compress.decode_cycles);
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    stats->async_dropped = (uint32_t)atomic_get(&prv_inst.async.ring.dropped);
+    stats->async_high_water = (uint32_t)atomic_get(&prv_inst.async.ring.high_water);
+#endif
+}
+
+/** @brief Zero the backend counters. Mutex must be held. */
+static void prv_fcb_reset_stats(void)
+{
+    memset(&prv_inst.stats, 0, sizeof(prv_inst.stats));
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    prv_inst.compress.encode_cycles = 0U;
+    prv_inst.compress.decode_cycles = 0U;
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    atomic_set(&prv_inst.async.ring.dropped, 0);
+    atomic_set(&prv_inst.async.ring.high_water, 0);
+#endif
+}
+
+#ifdef CONFIG_SHELL
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+int ovyl_log_storage_fcb_shell_index(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    ovyl_log_storage_time_index_t *ti = &prv_inst.time_index;
+    struct fcb *fcb = &prv_inst.fcb_inst;
+
+    int ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        shell_error(sh, "Unable to lock log storage: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Current boot: %u", ti->boot_id);
+
+    if (fcb->f_active.fe_sector != NULL) {
+        size_t idx = prv_sector_idx(fcb->f_oldest);
+
+        while (true) {
+            uint64_t first = ti->first_key[idx];
+            bool active = (&prv_inst.sectors[idx] == fcb->f_active.fe_sector);
+
+            if (first != LOG_STORAGE_TIME_KEY_NONE) {
+                /* A sector ends where the next indexed one starts. */
+                uint64_t last = active ? ti->last_key : LOG_STORAGE_TIME_KEY_NONE;
+                size_t next = idx;
+
+                while (!active && (last == LOG_STORAGE_TIME_KEY_NONE)) {
+                    next = (next + 1U) % fcb->f_sector_cnt;
+                    last = ti->first_key[next];
+                    if (&prv_inst.sectors[next] == fcb->f_active.fe_sector) {
+                        last = (last == LOG_STORAGE_TIME_KEY_NONE) ? ti->last_key : last;
+                        break;
+                    }
+                }
+
+                shell_print(sh, "sector %u: %u:%llu .. %u:%llu%s",
+                            (uint32_t)idx,
+                            (uint32_t)(first >> 48),
+                            (unsigned long long)(first & BIT64_MASK(48)),
+                            (uint32_t)(last >> 48),
+                            (unsigned long long)(last & BIT64_MASK(48)),
+                            active ? " (active)" : "");
+            }
+
+            if (active) {
+                break;
+            }
+
+            idx = (idx + 1U) % fcb->f_sector_cnt;
+        }
+    }
+
+    k_mutex_unlock(prv_inst.lock);
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_TIME_INDEX */
+
+/** @brief Print the FCB part of "log_storage stats". Mutex must be held. */
+static void prv_fcb_shell_stats(const struct shell *sh, const ovyl_log_storage_stats_t *stats)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_STAGING
+    shell_print(sh, "Staging buffer:");
+    shell_print(sh, "  Size:                %u bytes", CONFIG_OVYL_LOG_STORAGE_STAGING_SIZE);
+    shell_print(sh, "  Flushes:             %u", stats->staging_flushes);
+    shell_print(sh, "  Entries saved:       %u (last flush %u)",
+                stats->staging_entries_saved,
+                stats->staging_last_entries_saved);
+    shell_print(sh, "  Bytes saved:         %u (last flush %u)",
+                stats->staging_bytes_saved,
+                stats->staging_last_bytes_saved);
+#else
+    shell_print(sh, "Staging buffer: disabled");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC
+    shell_print(sh, "Async writer:");
+    shell_print(sh, "  Ring:                %u slots x %u bytes",
+                OVYL_LOG_STORAGE_RING_SLOTS,
+                OVYL_LOG_STORAGE_RING_SLOT_SIZE);
+    shell_print(sh, "  Overflow policy:     %s",
+                IS_ENABLED(CONFIG_OVYL_LOG_STORAGE_ASYNC_DROP_OLDEST) ? "drop-oldest"
+                                                                      : "drop-newest");
+    shell_print(sh, "  High-water mark:     %u slots", stats->async_high_water);
+    shell_print(sh, "  Dropped messages:    %u", stats->async_dropped);
+#else
+    shell_print(sh, "Async writer: disabled");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_COMPRESS
+    shell_print(sh, "Compression:");
+    shell_print(sh, "  Bytes in/out:        %u / %u", stats->compress_bytes_in, stats->compress_bytes_out);
+    if (stats->compress_bytes_out > 0U) {
+        shell_print(sh, "  Ratio:               %u.%02u:1",
+                    stats->compress_bytes_in / stats->compress_bytes_out,
+                    (uint32_t)(((uint64_t)(stats->compress_bytes_in % stats->compress_bytes_out) * 100U) /
+                               stats->compress_bytes_out));
+    }
+    if (stats->compress_bytes_in > 0U) {
+        shell_print(sh, "  Encode CPU:          %u us/KB",
+                    (uint32_t)(((uint64_t)stats->compress_us * 1024U) / stats->compress_bytes_in));
+    }
+    shell_print(sh, "  Decode CPU total:    %u us", stats->decompress_us);
+#else
+    shell_print(sh, "Compression: disabled");
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_READ_AHEAD
+    shell_print(sh, "Read-ahead:            %u fills, %u hits (%u byte window)",
+                stats->read_ahead_fills,
+                stats->read_ahead_hits,
+                CONFIG_OVYL_LOG_STORAGE_READ_AHEAD_SIZE);
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_LAZY_CLEAR
+    shell_print(sh, "Cleared, not erased:   %u sectors",
+                (prv_inst.floor.sector != NULL) ? (uint32_t)prv_sector_age(prv_inst.floor.sector) : 0U);
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    shell_print(sh, "Priority lane:         %u records (%u sectors)",
+                stats->lane_records,
+                (uint32_t)LOG_STORAGE_LANE_SECTORS);
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_PANIC_REGION
+    shell_print(sh, "Panic recovered:       %u bytes", stats->panic_recovered);
+#endif
+
+    shell_print(sh, "Flash programs:        %u for %u bytes (%u per KB)",
+                stats->program_ops,
+                stats->program_bytes,
+                (stats->program_bytes > 0U)
+                    ? (uint32_t)(((uint64_t)stats->program_ops * 1024U) / stats->program_bytes)
+                    : 0U);
+
+    shell_print(sh, "Append latency (worst case):");
+    shell_print(sh, "  Erase-ahead on:      %u us", stats->append_max_us_erase_ahead);
+    shell_print(sh, "  Erase-ahead off:     %u us", stats->append_max_us_inline);
+    shell_print(sh, "  Inline rotations:    %u", stats->inline_rotations);
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    shell_print(sh, "  Pre-erased sectors:  %u (erase-ahead %s)",
+                stats->erase_ahead_erases,
+                prv_inst.erase_ahead_enabled ? "on" : "off");
+#endif
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+int ovyl_log_storage_fcb_shell_watermark(const struct shell *sh, size_t argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        int ret = ovyl_log_storage_upload_reset();
+
+        if (ret < 0) {
+            shell_error(sh, "Failed to reset watermark: %d", ret);
+            return ret;
+        }
+
+        shell_print(sh, "Upload watermark reset.");
+        return 0;
+    }
+
+    int ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        shell_error(sh, "Unable to lock log storage: %d", ret);
+        return ret;
+    }
+
+    struct fcb_entry acked = prv_inst.upload.acked;
+
+    k_mutex_unlock(prv_inst.lock);
+
+    if (acked.fe_sector == NULL) {
+        shell_print(sh, "Upload watermark: none (next upload starts at oldest entry)");
+    } else {
+        shell_print(sh, "Upload watermark: sector %u offset %u",
+                    (uint32_t)(acked.fe_sector - prv_inst.sectors),
+                    acked.fe_elem_off);
+    }
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WATERMARK */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+int ovyl_log_storage_fcb_shell_erase_ahead(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc < 2) {
+        shell_print(sh, "Erase-ahead: %s", prv_inst.erase_ahead_enabled ? "on" : "off");
+        return 0;
+    }
+
+    bool enable;
+
+    if (strcmp(argv[1], "on") == 0) {
+        enable = true;
+    } else if (strcmp(argv[1], "off") == 0) {
+        enable = false;
+    } else {
+        shell_error(sh, "Invalid argument '%s'. Use 'on' or 'off'.", argv[1]);
+        return -EINVAL;
+    }
+
+    (void)ovyl_log_storage_set_erase_ahead(enable);
+    shell_print(sh, "Erase-ahead %s.", enable ? "enabled" : "disabled");
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+int ovyl_log_storage_fcb_shell_wear(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    static const char *const state_names[] = {"normal", "raised", "throttled"};
+    ovyl_log_storage_wear_status_t status;
+    uint32_t erases[LOG_STORAGE_NUM_SECTORS];
+
+    int ret = ovyl_log_storage_get_wear(&status);
+
+    if (ret < 0) {
+        shell_error(sh, "Unable to read wear counters: %d", ret);
+        return ret;
+    }
+
+    ret = k_mutex_lock(prv_inst.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+    if (ret < 0) {
+        shell_error(sh, "Unable to lock log storage: %d", ret);
+        return ret;
+    }
+
+    uint32_t sector_cnt = prv_inst.wear.rec.sector_cnt;
+    uint32_t main_cnt = prv_inst.fcb_inst.f_sector_cnt;
+
+    memcpy(erases, prv_inst.wear.rec.erases, sizeof(erases));
+    k_mutex_unlock(prv_inst.lock);
+
+    shell_print(sh, "Governor:        %s (storing up to %s)",
+                state_names[status.state],
+                ovyl_log_storage_level_name(status.level));
+    shell_print(sh, "Write budget:    %u bytes/hour", status.budget_per_hour);
+    shell_print(sh, "  This hour:     %u bytes", status.hour_bytes);
+    shell_print(sh, "  Last hour:     %u bytes", status.last_hour_bytes);
+    shell_print(sh, "  Throttled:     %u messages since boot", status.throttled);
+    shell_print(sh, "Lifetime:        %u KB written in %u of %u hours",
+                (uint32_t)(status.bytes / 1024U),
+                status.minutes / 60U,
+                LOG_STORAGE_WEAR_LIFETIME_HOURS);
+    shell_print(sh, "Sector erases:   worst %u of %u cycles", status.max_erases, LOG_STORAGE_WEAR_CYCLES);
+
+    for (uint32_t i = 0; i < sector_cnt; i++) {
+        shell_print(sh, "  %3u: %u%s", i, erases[i], (i < main_cnt) ? "" : " (reserved)");
+    }
+
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_WEAR */
+
+#endif /* CONFIG_SHELL */
+
+const ovyl_log_storage_backend_api_t ovyl_log_storage_backend_fcb = {
+    .unit = "sector",
+    .init = prv_fcb_init,
+    .append = prv_fcb_append,
+#ifdef CONFIG_OVYL_LOG_STORAGE_RECORD_HDR
+    .append_record = prv_fcb_append_record,
+#endif
+    .flush = prv_fcb_flush,
+    .panic = prv_fcb_panic,
+    .sync = prv_flush_pending,
+    .read = prv_read_ctx_fetch,
+    .read_bulk = prv_read_ctx_fetch_bulk,
+    .position = prv_fcb_position,
+    .snapshot_begin = prv_snapshot_begin,
+    .snapshot_end = prv_snapshot_end,
+    .snapshot_rewind = prv_snapshot_rewind,
+    .export_begin = prv_fcb_export_begin,
+#ifdef CONFIG_OVYL_LOG_STORAGE_PRIORITY_LANE
+    .export_read = prv_fcb_export_read,
+#endif
+    .clear = prv_fcb_clear_logs,
+#ifdef CONFIG_OVYL_LOG_STORAGE_TIME_INDEX
+    .seek_time = prv_fcb_seek_time,
+    .boot_id = prv_fcb_boot_id,
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_WATERMARK
+    .upload_fetch = prv_fcb_upload_fetch,
+    .upload_ack = prv_fcb_upload_ack,
+    .upload_rewind = prv_fcb_upload_rewind,
+    .upload_reset = prv_fcb_upload_reset,
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_ERASE_AHEAD
+    .set_erase_ahead = prv_fcb_set_erase_ahead,
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_WEAR
+    .get_wear = prv_fcb_get_wear,
+    .wear_level = prv_fcb_wear_level,
+#endif
+    .get_stats = prv_fcb_get_stats,
+    .reset_stats = prv_fcb_reset_stats,
+#ifdef CONFIG_SHELL
+    .shell_stats = prv_fcb_shell_stats,
+#endif
+};
@@ -0,0 +1,751 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_level.c
+ * @brief Runtime log level management shared by the log storage backends.
+ */
+
+#include "log_storage_level.h"
+
+#include <ovyl/log_storage.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+#include <ovyl/flash_log_backend.h>
+#endif
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_internal.h>
+#include <zephyr/sys/util.h>
+
+#include <ovyl/config_mgr.h>
+#include <ovyl/configs.h>
+
+#include "log_storage_cfg.h"
+
+LOG_MODULE_DECLARE(ovyl_log_storage, CONFIG_OVYL_LOG_STORAGE_LOG_LEVEL);
+
+#define LOG_RUNTIME_MIN_LEVEL CONFIG_OVYL_LOG_STORAGE_MIN_RUNTIME_LEVEL
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+#define LOG_MODULE_LEVELS_MAX CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS_MAX
+
+BUILD_ASSERT(LOG_MODULE_LEVELS_MAX <= UINT8_MAX, "Override count must fit the persisted count");
+OVYL_LOG_STORAGE_CFG_CHECK(CFG_LOG_STORAGE_MODULE_LEVELS, ovyl_log_storage_module_levels_t);
+
+/* Persisted overrides, mirrored in RAM. */
+static ovyl_log_storage_module_levels_t prv_module_levels;
+#endif
+
+/* Global level last applied, used for modules without an override. */
+static uint8_t prv_global_level = CONFIG_LOG_DEFAULT_LEVEL;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+OVYL_LOG_STORAGE_CFG_CHECK(CFG_LOG_STORAGE_FLASH_LEVEL, uint8_t);
+
+/* Most verbose level the flash backend stores, whatever the console backends get. */
+static uint8_t prv_flash_level = CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL_DEFAULT;
+#endif
+
+const char *ovyl_log_storage_level_name(uint8_t level)
+{
+    switch (level) {
+        case LOG_LEVEL_NONE:
+            return "OFF";
+        case LOG_LEVEL_ERR:
+            return "ERR";
+        case LOG_LEVEL_WRN:
+            return "WRN";
+        case LOG_LEVEL_INF:
+            return "INF";
+        case LOG_LEVEL_DBG:
+            return "DBG";
+        default:
+            return "UNK";
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint8_t level;
+} prv_log_level_entry_t;
+
+static const prv_log_level_entry_t prv_log_levels[] = {
+    {"off", LOG_LEVEL_NONE},
+    {"err", LOG_LEVEL_ERR},
+    {"wrn", LOG_LEVEL_WRN},
+    {"inf", LOG_LEVEL_INF},
+    {"dbg", LOG_LEVEL_DBG},
+};
+
+/** @brief Resolve a textual log level into the matching table entry. */
+static const prv_log_level_entry_t *prv_find_log_level(const char *name)
+{
+    if (name == NULL) {
+        return NULL;
+    }
+
+    size_t input_len = strlen(name);
+
+    for (size_t i = 0; i < ARRAY_SIZE(prv_log_levels); i++) {
+        const char *candidate = prv_log_levels[i].name;
+        size_t cand_len = strlen(candidate);
+
+        if (input_len != cand_len) {
+            continue;
+        }
+
+        bool match = true;
+        for (size_t j = 0; j < cand_len; j++) {
+            if ((char)tolower((unsigned char)name[j]) != candidate[j]) {
+                match = false;
+                break;
+            }
+        }
+
+        if (match) {
+            return &prv_log_levels[i];
+        }
+    }
+
+    return NULL;
+}
+
+int ovyl_log_storage_level_parse(const char *name, uint8_t *level)
+{
+    const prv_log_level_entry_t *entry = prv_find_log_level(name);
+
+    if ((entry == NULL) || (level == NULL)) {
+        return -EINVAL;
+    }
+
+    *level = entry->level;
+    return 0;
+}
+
+/** @brief Find the local domain source registered as @p module. */
+static int prv_source_find(const char *module, uint32_t *source_id)
+{
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+
+    if (module == NULL) {
+        return -EINVAL;
+    }
+
+    for (uint32_t id = 0; id < source_count; id++) {
+        const char *name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, id);
+
+        if ((name != NULL) && (strcmp(name, module) == 0)) {
+            *source_id = id;
+            return 0;
+        }
+    }
+
+    return -ENOENT;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+/** @brief 32-bit FNV-1a hash of a module name; stable across builds. */
+static uint32_t prv_module_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+
+    for (const char *c = name; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/** @brief Level of override @p idx. */
+static uint8_t prv_override_level(size_t idx)
+{
+    return (uint8_t)(LOG_LEVEL_ERR + ((prv_module_levels.levels[idx / 4U] >> ((idx % 4U) * 2U)) & 0x03U));
+}
+
+/** @brief Store @p level as the level of override @p idx. */
+static void prv_override_level_set(size_t idx, uint8_t level)
+{
+    uint8_t shift = (uint8_t)((idx % 4U) * 2U);
+    uint8_t *byte = &prv_module_levels.levels[idx / 4U];
+
+    *byte = (uint8_t)((*byte & ~(0x03U << shift)) | (((level - LOG_LEVEL_ERR) & 0x03U) << shift));
+}
+
+/**
+ * @brief Binary search the sorted override hashes.
+ *
+ * @retval true @p idx is the override of @p hash.
+ * @retval false No override; @p idx is where it would be inserted.
+ */
+static bool prv_override_find(uint32_t hash, size_t *idx)
+{
+    size_t lo = 0U;
+    size_t hi = prv_module_levels.count;
+
+    while (lo < hi) {
+        size_t mid = lo + ((hi - lo) / 2U);
+
+        if (prv_module_levels.hashes[mid] < hash) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+
+    *idx = lo;
+    return (lo < prv_module_levels.count) && (prv_module_levels.hashes[lo] == hash);
+}
+
+/** @brief Load the persisted overrides, dropping a record that is not sorted or too long. */
+static void prv_module_levels_load(void)
+{
+    ovyl_log_storage_module_levels_t *ml = &prv_module_levels;
+    bool valid = ovyl_config_mgr_get_value(CFG_LOG_STORAGE_MODULE_LEVELS, ml, sizeof(*ml)) &&
+                 (ml->count <= LOG_MODULE_LEVELS_MAX);
+
+    for (size_t i = 1U; valid && (i < ml->count); i++) {
+        valid = (ml->hashes[i - 1U] < ml->hashes[i]);
+    }
+
+    if (!valid) {
+        memset(ml, 0, sizeof(*ml));
+    }
+}
+
+/** @brief Persist the override table. */
+static int prv_module_levels_save(void)
+{
+    if (!ovyl_config_mgr_set_value(CFG_LOG_STORAGE_MODULE_LEVELS, &prv_module_levels, sizeof(prv_module_levels))) {
+        LOG_ERR("Failed to save module log levels to config");
+        return -EIO;
+    }
+
+    return 0;
+}
+
+/** @brief Look up the override of the module registered as @p source_id. */
+static bool prv_source_override(uint32_t source_id, uint8_t *level)
+{
+    const char *name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id);
+    size_t idx;
+
+    if ((name == NULL) || (prv_module_levels.count == 0U) || !prv_override_find(prv_module_hash(name), &idx)) {
+        return false;
+    }
+
+    *level = prv_override_level(idx);
+    return true;
+}
+#else
+/** @brief Without per-module overrides every module follows the global level. */
+static bool prv_source_override(uint32_t source_id, uint8_t *level)
+{
+    ARG_UNUSED(source_id);
+    ARG_UNUSED(level);
+
+    return false;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS */
+
+/**
+ * @brief Apply @p level to one source on every backend, capped by the flash level on the flash backend.
+ *
+ * @return Level the console backends got, as reported by log_filter_set().
+ */
+static uint32_t prv_source_apply(uint32_t source_id, uint8_t level)
+{
+    uint32_t result_level = log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, level);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+    (void)log_filter_set(ovyl_flash_log_backend_get(), Z_LOG_LOCAL_DOMAIN_ID, source_id, MIN(level, prv_flash_level));
+#endif
+
+    return result_level;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+/** @brief Load the persisted flash level, falling back to the Kconfig default. */
+static void prv_flash_level_load(void)
+{
+    uint8_t level;
+
+    if (!ovyl_config_mgr_get_value(CFG_LOG_STORAGE_FLASH_LEVEL, &level, sizeof(level)) || (level > LOG_LEVEL_DBG)) {
+        level = CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL_DEFAULT;
+    }
+
+    prv_flash_level = MAX(level, (uint8_t)LOG_RUNTIME_MIN_LEVEL);
+}
+#endif
+
+void ovyl_log_storage_init_log_level(void)
+{
+    uint8_t log_level;
+    bool use_default = false;
+
+    if (ovyl_config_mgr_get_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level))) {
+        if (log_level > LOG_LEVEL_DBG) {
+            use_default = true;
+        }
+    } else {
+        use_default = true;
+    }
+
+    if (use_default) {
+        log_level = CONFIG_LOG_DEFAULT_LEVEL;
+        ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level));
+    }
+
+    if (log_level < LOG_RUNTIME_MIN_LEVEL) {
+        log_level = LOG_RUNTIME_MIN_LEVEL;
+        LOG_WRN("Persisted log level is below minimum; clamping to %u", log_level);
+        ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &log_level, sizeof(log_level));
+    }
+
+    prv_global_level = log_level;
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+    prv_module_levels_load();
+#endif
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+    prv_flash_level_load();
+#endif
+
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+    uint32_t set_count = 0;
+    uint32_t override_count = 0;
+
+    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+        uint8_t level = log_level;
+
+        if (prv_source_override(source_id, &level)) {
+            override_count++;
+        }
+
+        uint32_t result_level = prv_source_apply(source_id, level);
+        if (result_level == level) {
+            set_count++;
+        }
+    }
+
+    LOG_INF("Log level initialized: %u (applied to %u/%u modules, %u overridden)",
+            log_level,
+            set_count,
+            source_count,
+            override_count);
+}
+
+int ovyl_log_storage_set_log_level(uint8_t level)
+{
+    if (level > LOG_LEVEL_DBG) {
+        LOG_ERR("Invalid log level: %u. Valid levels: %u=ERR, %u=WRN, %u=INF, %u=DBG",
+                level,
+                LOG_LEVEL_ERR,
+                LOG_LEVEL_WRN,
+                LOG_LEVEL_INF,
+                LOG_LEVEL_DBG);
+        return -EINVAL;
+    }
+
+    uint8_t clamped_level = level;
+    if (clamped_level < LOG_RUNTIME_MIN_LEVEL) {
+        clamped_level = LOG_RUNTIME_MIN_LEVEL;
+    }
+
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+
+    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+        uint8_t override;
+
+        if (!prv_source_override(source_id, &override)) {
+            (void)prv_source_apply(source_id, clamped_level);
+        }
+    }
+
+    prv_global_level = clamped_level;
+
+    if (!ovyl_config_mgr_set_value(CFG_LOG_LEVEL, &clamped_level, sizeof(clamped_level))) {
+        LOG_ERR("Failed to save log level to config");
+        return -EIO;
+    }
+
+    if (clamped_level != level) {
+        LOG_WRN("Requested level %u clamped to minimum runtime level %u", level, clamped_level);
+    }
+
+    const char *level_name = ovyl_log_storage_level_name(clamped_level);
+    LOG_INF("Log level set to: %s (%u)", level_name, clamped_level);
+
+    return 0;
+}
+
+int ovyl_log_storage_set_flash_level(uint8_t level)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+    if ((level < LOG_LEVEL_ERR) || (level > LOG_LEVEL_DBG)) {
+        return -EINVAL;
+    }
+
+    prv_flash_level = MAX(level, (uint8_t)LOG_RUNTIME_MIN_LEVEL);
+
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+
+    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+        uint8_t source_level = prv_global_level;
+
+        (void)prv_source_override(source_id, &source_level);
+        (void)log_filter_set(ovyl_flash_log_backend_get(),
+                             Z_LOG_LOCAL_DOMAIN_ID,
+                             source_id,
+                             MIN(source_level, prv_flash_level));
+    }
+
+    if (!ovyl_config_mgr_set_value(CFG_LOG_STORAGE_FLASH_LEVEL, &prv_flash_level, sizeof(prv_flash_level))) {
+        LOG_ERR("Failed to save flash log level to config");
+        return -EIO;
+    }
+
+    LOG_INF("Flash log level set to: %s (%u)", ovyl_log_storage_level_name(prv_flash_level), prv_flash_level);
+    return 0;
+#else
+    ARG_UNUSED(level);
+    return -ENOTSUP;
+#endif
+}
+
+uint8_t ovyl_log_storage_get_flash_level(void)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+    return prv_flash_level;
+#else
+    return LOG_LEVEL_DBG;
+#endif
+}
+
+int ovyl_log_storage_set_module_level(const char *module, uint8_t level)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+    ovyl_log_storage_module_levels_t *ml = &prv_module_levels;
+    uint32_t source_id;
+    size_t idx;
+
+    if ((level < LOG_LEVEL_ERR) || (level > LOG_LEVEL_DBG)) {
+        return -EINVAL;
+    }
+
+    int ret = prv_source_find(module, &source_id);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    uint8_t clamped_level = MAX(level, (uint8_t)LOG_RUNTIME_MIN_LEVEL);
+    uint32_t hash = prv_module_hash(module);
+
+    if (!prv_override_find(hash, &idx)) {
+        if (ml->count >= LOG_MODULE_LEVELS_MAX) {
+            return -ENOMEM;
+        }
+
+        for (size_t i = ml->count; i > idx; i--) {
+            ml->hashes[i] = ml->hashes[i - 1U];
+            prv_override_level_set(i, prv_override_level(i - 1U));
+        }
+
+        ml->hashes[idx] = hash;
+        ml->count++;
+    }
+
+    prv_override_level_set(idx, clamped_level);
+    (void)prv_source_apply(source_id, clamped_level);
+
+    ret = prv_module_levels_save();
+    if (ret == 0) {
+        LOG_INF("Log level of %s set to: %s (%u)", module, ovyl_log_storage_level_name(clamped_level), clamped_level);
+    }
+
+    return ret;
+#else
+    ARG_UNUSED(module);
+    ARG_UNUSED(level);
+    return -ENOTSUP;
+#endif
+}
+
+int ovyl_log_storage_get_module_level(const char *module, uint8_t *level, bool *overridden)
+{
+    uint32_t source_id;
+
+    if (level == NULL) {
+        return -EINVAL;
+    }
+
+    int ret = prv_source_find(module, &source_id);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    *level = (uint8_t)log_filter_get(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, true);
+    if (overridden != NULL) {
+        uint8_t override;
+
+        *overridden = prv_source_override(source_id, &override);
+    }
+
+    return 0;
+}
+
+int ovyl_log_storage_reset_module_level(const char *module)
+{
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+    ovyl_log_storage_module_levels_t *ml = &prv_module_levels;
+    uint32_t source_id;
+    size_t idx;
+
+    int ret = prv_source_find(module, &source_id);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (!prv_override_find(prv_module_hash(module), &idx)) {
+        return 0;
+    }
+
+    for (size_t i = idx + 1U; i < ml->count; i++) {
+        ml->hashes[i - 1U] = ml->hashes[i];
+        prv_override_level_set(i - 1U, prv_override_level(i));
+    }
+
+    ml->count--;
+    ml->hashes[ml->count] = 0U;
+    prv_override_level_set(ml->count, LOG_LEVEL_ERR);
+
+    (void)prv_source_apply(source_id, prv_global_level);
+
+    return prv_module_levels_save();
+#else
+    ARG_UNUSED(module);
+    return -ENOTSUP;
+#endif
+}
+
+
+#ifdef CONFIG_SHELL
+
+/** @brief Print a table of compiled and runtime log levels for each module. */
+static int prv_shell_list_module_log_levels(const struct shell *sh)
+{
+    uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+
+    shell_print(sh, "Module Log Levels (%u modules):", source_count);
+    shell_print(sh, "%-24s %-8s %-8s", "Module", "Runtime", "Compiled");
+    shell_print(sh, "%-24s %-8s %-8s", "------", "-------", "--------");
+
+    for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+        const char *source_name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id);
+        uint32_t runtime_level = log_filter_get(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, true);
+        uint32_t compiled_level = log_filter_get(NULL, Z_LOG_LOCAL_DOMAIN_ID, source_id, false);
+
+        const char *runtime_name = ovyl_log_storage_level_name(runtime_level);
+        const char *compiled_name = ovyl_log_storage_level_name(compiled_level);
+        uint8_t override;
+
+        shell_print(sh,
+                    "%-24s %-8s %-8s%s",
+                    source_name ? source_name : "unknown",
+                    runtime_name,
+                    compiled_name,
+                    prv_source_override(source_id, &override) ? " (module override)" : "");
+    }
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+    shell_print(sh, "\nFlash backend stores up to %s.", ovyl_log_storage_level_name(prv_flash_level));
+#endif
+
+    shell_print(sh, "\nUse 'log_storage set_log_level <level>' to change runtime levels for all modules.");
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+    shell_print(sh, "Use 'log_storage set_module_level <module> <level>' to override one module.");
+#endif
+
+    return 0;
+}
+
+int ovyl_log_storage_shell_list_levels(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "Available severity levels:");
+    for (size_t i = 0; i < ARRAY_SIZE(prv_log_levels); i++) {
+        shell_print(sh, "  %s", prv_log_levels[i].name);
+    }
+
+    shell_print(sh, "\nModule log level summary:");
+    return prv_shell_list_module_log_levels(sh);
+}
+
+/** @brief Parse a shell level argument given by name or number. */
+static int prv_shell_parse_level(const struct shell *sh, const char *arg, uint8_t *level)
+{
+    const prv_log_level_entry_t *entry = prv_find_log_level(arg);
+
+    if (entry != NULL) {
+        *level = entry->level;
+        return 0;
+    }
+
+    char *endptr = NULL;
+    long numeric = strtol(arg, &endptr, 10);
+    if ((endptr == NULL) || (*endptr != '\0') || numeric < LOG_RUNTIME_MIN_LEVEL || numeric > LOG_LEVEL_DBG) {
+        shell_error(sh, "Invalid level '%s'. Use one of: err, wrn, inf, dbg, or 1-4.", arg);
+        return -EINVAL;
+    }
+
+    *level = (uint8_t)numeric;
+    return 0;
+}
+
+int ovyl_log_storage_shell_set_level(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc < 2) {
+        shell_error(sh, "Missing level argument. Usage: log_storage set_log_level <err|wrn|inf|dbg|1-4>");
+        return -EINVAL;
+    }
+
+    uint8_t level;
+
+    if (prv_shell_parse_level(sh, argv[1], &level) < 0) {
+        return -EINVAL;
+    }
+
+    int ret = ovyl_log_storage_set_log_level(level);
+    if (ret < 0) {
+        shell_error(sh, "Failed to set log level: %d", ret);
+        return ret;
+    }
+
+    uint8_t clamped = level < LOG_RUNTIME_MIN_LEVEL ? LOG_RUNTIME_MIN_LEVEL : level;
+    const char *name = ovyl_log_storage_level_name(clamped);
+    shell_print(sh, "Log level set to %s (%u).", name, (unsigned int)clamped);
+    return 0;
+}
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+int ovyl_log_storage_shell_flash_level(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc < 2) {
+        shell_print(sh, "Flash log level: %s (%u)",
+                    ovyl_log_storage_level_name(prv_flash_level),
+                    (unsigned int)prv_flash_level);
+        return 0;
+    }
+
+    uint8_t level;
+
+    if (prv_shell_parse_level(sh, argv[1], &level) < 0) {
+        return -EINVAL;
+    }
+
+    int ret = ovyl_log_storage_set_flash_level(level);
+    if (ret < 0) {
+        shell_error(sh, "Failed to set flash log level: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Flash log level set to %s (%u).",
+                ovyl_log_storage_level_name(prv_flash_level),
+                (unsigned int)prv_flash_level);
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL */
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+int ovyl_log_storage_shell_set_module_level(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+
+    int ret;
+
+    if (strcmp(argv[2], "default") == 0) {
+        ret = ovyl_log_storage_reset_module_level(argv[1]);
+    } else {
+        uint8_t level;
+
+        if (prv_shell_parse_level(sh, argv[2], &level) < 0) {
+            return -EINVAL;
+        }
+
+        ret = ovyl_log_storage_set_module_level(argv[1], level);
+    }
+
+    if (ret == -ENOENT) {
+        shell_error(sh, "Unknown module '%s'. See 'log_storage list_log_levels'.", argv[1]);
+        return ret;
+    }
+
+    if (ret == -ENOMEM) {
+        shell_error(sh, "All %u module overrides are in use.", (unsigned int)LOG_MODULE_LEVELS_MAX);
+        return ret;
+    }
+
+    if (ret < 0) {
+        shell_error(sh, "Failed to set module log level: %d", ret);
+        return ret;
+    }
+
+    return ovyl_log_storage_shell_get_module_level(sh, 2, argv);
+}
+
+int ovyl_log_storage_shell_get_module_level(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc < 2) {
+        uint32_t source_count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+        uint32_t matched = 0U;
+
+        for (uint32_t source_id = 0; source_id < source_count; source_id++) {
+            uint8_t level;
+
+            if (prv_source_override(source_id, &level)) {
+                shell_print(sh, "%-24s %s", log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, source_id),
+                            ovyl_log_storage_level_name(level));
+                matched++;
+            }
+        }
+
+        shell_print(sh, "%u of %u overrides in use (%u match no module in this build).",
+                    (unsigned int)prv_module_levels.count,
+                    (unsigned int)LOG_MODULE_LEVELS_MAX,
+                    (unsigned int)(prv_module_levels.count - MIN(matched, prv_module_levels.count)));
+        return 0;
+    }
+
+    uint8_t level;
+    bool overridden;
+    int ret = ovyl_log_storage_get_module_level(argv[1], &level, &overridden);
+
+    if (ret < 0) {
+        shell_error(sh, "Unknown module '%s'. See 'log_storage list_log_levels'.", argv[1]);
+        return ret;
+    }
+
+    shell_print(sh, "%s: %s (%s)", argv[1], ovyl_log_storage_level_name(level),
+                overridden ? "module override" : "global level");
+    return 0;
+}
+#endif /* CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS */
+
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_level.h
+ * @brief Runtime log level helpers shared by the log storage backends.
+ */
+
+#ifndef OVYL_LOG_STORAGE_LEVEL_H
+#define OVYL_LOG_STORAGE_LEVEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+/**
+ * @brief Resolve a textual log level (off, err, wrn, inf, dbg; any case).
+ *
+ * @param name Level name.
+ * @param level Populated with the matching Zephyr log level.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Unknown name.
+ */
+int ovyl_log_storage_level_parse(const char *name, uint8_t *level);
+
+/** @brief Convert a Zephyr log severity level to a printable name. */
+const char *ovyl_log_storage_level_name(uint8_t level);
+
+#ifdef CONFIG_SHELL
+/** @brief Shell handler that lists available severities and the level of every module. */
+int ovyl_log_storage_shell_list_levels(const struct shell *sh, size_t argc, char **argv);
+
+/** @brief Shell handler that sets and persists the runtime level of every module. */
+int ovyl_log_storage_shell_set_level(const struct shell *sh, size_t argc, char **argv);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_MODULE_LEVELS
+/** @brief Shell handler that sets and persists, or resets, the level of one module. */
+int ovyl_log_storage_shell_set_module_level(const struct shell *sh, size_t argc, char **argv);
+
+/** @brief Shell handler that prints the level of one module, or every override. */
+int ovyl_log_storage_shell_get_module_level(const struct shell *sh, size_t argc, char **argv);
+
+/** @brief Per-module level entries, appended to OVYL_LOG_STORAGE_LEVEL_SHELL_CMDS. */
+#define OVYL_LOG_STORAGE_MODULE_LEVEL_SHELL_CMDS                                                   \
+    , SHELL_CMD_ARG(set_module_level,                                                              \
+                    NULL,                                                                          \
+                    "Set and persist the log level of one module,\n"                               \
+                    "or return it to the global level.\n"                                          \
+                    "usage:\n"                                                                     \
+                    "$ log_storage set_module_level <module> <err|wrn|inf|dbg|1-4|default>\n",     \
+                    ovyl_log_storage_shell_set_module_level,                                       \
+                    3,                                                                             \
+                    0),                                                                            \
+    SHELL_CMD_ARG(get_module_level,                                                                \
+                  NULL,                                                                            \
+                  "Print the log level of one module, or list every override.\n"                   \
+                  "usage:\n"                                                                       \
+                  "$ log_storage get_module_level [module]\n",                                     \
+                  ovyl_log_storage_shell_get_module_level,                                         \
+                  1,                                                                               \
+                  1)
+#else
+#define OVYL_LOG_STORAGE_MODULE_LEVEL_SHELL_CMDS
+#endif
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_FLASH_LEVEL
+/** @brief Shell handler that prints, or sets and persists, the flash backend level. */
+int ovyl_log_storage_shell_flash_level(const struct shell *sh, size_t argc, char **argv);
+
+/** @brief Flash level entry, appended to OVYL_LOG_STORAGE_LEVEL_SHELL_CMDS. */
+#define OVYL_LOG_STORAGE_FLASH_LEVEL_SHELL_CMDS                                                    \
+    , SHELL_CMD_ARG(flash_level,                                                                   \
+                    NULL,                                                                          \
+                    "Print or set the most verbose level stored in flash,\n"                       \
+                    "independent of the console backends.\n"                                       \
+                    "usage:\n"                                                                     \
+                    "$ log_storage flash_level [err|wrn|inf|dbg|1-4]\n",                           \
+                    ovyl_log_storage_shell_flash_level,                                            \
+                    1,                                                                             \
+                    1)
+#else
+#define OVYL_LOG_STORAGE_FLASH_LEVEL_SHELL_CMDS
+#endif
+
+/** @brief Log level entries of the log_storage shell command, shared by every backend. */
+#define OVYL_LOG_STORAGE_LEVEL_SHELL_CMDS                                                          \
+    SHELL_CMD_ARG(list_log_levels,                                                                 \
+                  NULL,                                                                            \
+                  "List current module log levels and available severities.\n"                     \
+                  "usage:\n"                                                                       \
+                  "$ log_storage list_log_levels\n",                                               \
+                  ovyl_log_storage_shell_list_levels,                                              \
+                  1,                                                                               \
+                  0),                                                                              \
+    SHELL_CMD_ARG(set_log_level,                                                                   \
+                  NULL,                                                                            \
+                  "Set runtime log level for all modules (minimum 'err').\n"                       \
+                  "usage:\n"                                                                       \
+                  "$ log_storage set_log_level <err|wrn|inf|dbg|1-4>\n",                           \
+                  ovyl_log_storage_shell_set_level,                                                \
+                  2,                                                                               \
+                  0)                                                                               \
+    OVYL_LOG_STORAGE_MODULE_LEVEL_SHELL_CMDS                                                       \
+    OVYL_LOG_STORAGE_FLASH_LEVEL_SHELL_CMDS
+#endif /* CONFIG_SHELL */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVYL_LOG_STORAGE_LEVEL_H */
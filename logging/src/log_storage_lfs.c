@@ -0,0 +1,661 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_lfs.c
+ * @brief LittleFS log storage backend: one append-only file per boot.
+ *
+ * Segments are files named after their number in hex ("0000002a.log") inside
+ * CONFIG_OVYL_LOG_STORAGE_LFS_DIR. Init starts the segment after the newest
+ * one found, so every boot gets its own file, and the oldest files are
+ * deleted whenever the directory outgrows CONFIG_OVYL_LOG_STORAGE_LFS_MAX_SIZE.
+ *
+ * The segments form one byte stream, so reads return plain byte ranges rather
+ * than entries. Appends are committed CONFIG_OVYL_LOG_STORAGE_LFS_SYNC_MS
+ * after the first one that is still buffered, or right away in panic mode.
+ */
+
+#include "log_storage_backend.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_DECLARE(ovyl_log_storage, CONFIG_OVYL_LOG_STORAGE_LOG_LEVEL);
+
+#define LOG_STORAGE_LFS_DIR CONFIG_OVYL_LOG_STORAGE_LFS_DIR
+#define LOG_STORAGE_LFS_MAX_SIZE ((size_t)CONFIG_OVYL_LOG_STORAGE_LFS_MAX_SIZE)
+#define LOG_STORAGE_LFS_SUFFIX ".log"
+#define LOG_STORAGE_LFS_SYNC_MS CONFIG_OVYL_LOG_STORAGE_LFS_SYNC_MS
+#define LOG_STORAGE_MUTEX_TIMEOUT_MS (200U)
+/* Directory, separator, eight hex digits, suffix and terminator. */
+#define LOG_STORAGE_LFS_PATH_MAX (sizeof(LOG_STORAGE_LFS_DIR) + 1U + 8U + sizeof(LOG_STORAGE_LFS_SUFFIX))
+
+/** @brief End of data and oldest unread segment captured for an export. */
+typedef struct {
+    uint32_t end_segment;
+    uint32_t end_offset;
+    uint32_t pin; /**< Oldest segment pruning must keep. */
+    bool active;
+} ovyl_log_storage_lfs_snapshot_t;
+
+/** @brief Backend state. */
+typedef struct {
+    struct k_mutex *lock;       /**< Front end mutex. */
+    struct k_work_delayable sync_work;
+    struct fs_file_t file;      /**< Newest segment, open for appending. */
+    struct fs_file_t read_file; /**< Segment currently being read. */
+    uint32_t oldest;            /**< Oldest segment on the file system. */
+    uint32_t current;           /**< Segment appends go to. */
+    uint32_t current_size;      /**< Bytes in the current segment. */
+    uint32_t read_segment;      /**< Segment open in read_file. */
+    size_t used;                /**< Bytes in all segments. */
+    bool open;                  /**< file is open. */
+    bool read_open;             /**< read_file is open. */
+    bool dirty;                 /**< Appends since the last sync. */
+    bool panic_mode;            /**< Commit every append right away. */
+    ovyl_log_storage_lfs_snapshot_t snapshot;
+    uint32_t append_max_us;     /**< Worst append latency. */
+    uint32_t export_dropped;    /**< Appends refused to keep the export snapshot. */
+} prv_lfs_state_t;
+
+static prv_lfs_state_t prv_lfs;
+
+/** @brief Build the path of segment @p segment. */
+static void prv_lfs_path(char *path, uint32_t segment)
+{
+    (void)snprintf(path, LOG_STORAGE_LFS_PATH_MAX, "%s/%08x" LOG_STORAGE_LFS_SUFFIX, LOG_STORAGE_LFS_DIR, segment);
+}
+
+/** @brief Parse a segment file name; false for files the backend does not own. */
+static bool prv_lfs_parse_name(const char *name, uint32_t *segment)
+{
+    char *end = NULL;
+    unsigned long value = strtoul(name, &end, 16);
+
+    if ((end != &name[8]) || (strcmp(end, LOG_STORAGE_LFS_SUFFIX) != 0)) {
+        return false;
+    }
+
+    *segment = (uint32_t)value;
+    return true;
+}
+
+/** @brief Close the read handle, e.g. before its segment is deleted. */
+static void prv_lfs_read_close(void)
+{
+    if (prv_lfs.read_open) {
+        (void)fs_close(&prv_lfs.read_file);
+        prv_lfs.read_open = false;
+    }
+}
+
+/** @brief Find the oldest and newest segments and their total size. */
+static int prv_lfs_scan(bool *found)
+{
+    struct fs_dir_t dir;
+    struct fs_dirent entry;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0U;
+
+    *found = false;
+    prv_lfs.used = 0U;
+
+    fs_dir_t_init(&dir);
+
+    int ret = fs_opendir(&dir, LOG_STORAGE_LFS_DIR);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    while (((ret = fs_readdir(&dir, &entry)) == 0) && (entry.name[0] != '\0')) {
+        uint32_t segment;
+
+        if ((entry.type != FS_DIR_ENTRY_FILE) || !prv_lfs_parse_name(entry.name, &segment)) {
+            continue;
+        }
+
+        *found = true;
+        min = MIN(min, segment);
+        max = MAX(max, segment);
+        prv_lfs.used += entry.size;
+    }
+
+    (void)fs_closedir(&dir);
+
+    if (*found) {
+        prv_lfs.oldest = min;
+        prv_lfs.current = max;
+    }
+
+    return ret;
+}
+
+/** @brief Create segment @p segment and make it the append target. */
+static int prv_lfs_start_segment(uint32_t segment)
+{
+    char path[LOG_STORAGE_LFS_PATH_MAX];
+
+    prv_lfs_path(path, segment);
+    fs_file_t_init(&prv_lfs.file);
+
+    int ret = fs_open(&prv_lfs.file, path, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+
+    if (ret < 0) {
+        LOG_ERR("Failed to create %s: %d", path, ret);
+        return ret;
+    }
+
+    prv_lfs.open = true;
+    prv_lfs.dirty = false;
+    prv_lfs.current = segment;
+    prv_lfs.current_size = 0U;
+    return 0;
+}
+
+/** @brief Check whether a reader had not finished @p arg, the segment being deleted. */
+static bool prv_reader_in_segment(const ovyl_log_storage_read_ctx_t *ctx, void *arg)
+{
+    return ctx->started && (ctx->segment == *(const uint32_t *)arg);
+}
+
+/**
+ * @brief Delete the oldest segments until @p extra more bytes fit the budget.
+ *
+ * Stops before the segment an export snapshot pins and never deletes the
+ * current segment. Readers still inside a deleted segment restart at the
+ * oldest one. Mutex must be held.
+ *
+ * @retval 0 The bytes fit, or only the current segment is left.
+ * @retval -ENOSPC The pinned segment would have to be deleted.
+ */
+static int prv_lfs_prune(size_t extra)
+{
+    char path[LOG_STORAGE_LFS_PATH_MAX];
+    uint32_t keep = prv_lfs.snapshot.active ? prv_lfs.snapshot.pin : UINT32_MAX;
+
+    while (((prv_lfs.used + extra) > LOG_STORAGE_LFS_MAX_SIZE) && (prv_lfs.oldest != prv_lfs.current)) {
+        struct fs_dirent entry;
+
+        if (prv_lfs.oldest >= keep) {
+            return -ENOSPC;
+        }
+
+        prv_lfs_path(path, prv_lfs.oldest);
+
+        if ((fs_stat(path, &entry) == 0) && (entry.type == FS_DIR_ENTRY_FILE)) {
+            if (prv_lfs.read_open && (prv_lfs.read_segment == prv_lfs.oldest)) {
+                prv_lfs_read_close();
+            }
+
+            int ret = fs_unlink(path);
+
+            if (ret < 0) {
+                LOG_ERR("Failed to delete %s: %d", path, ret);
+                return ret;
+            }
+
+            prv_lfs.used -= MIN(prv_lfs.used, entry.size);
+        }
+
+        ovyl_log_storage_readers_drop(prv_reader_in_segment, &prv_lfs.oldest);
+        prv_lfs.oldest++;
+    }
+
+    return 0;
+}
+
+/** @brief Commit the current segment so its appends survive a reset. Mutex must be held. */
+static int prv_lfs_sync(void)
+{
+    if (!prv_lfs.open || !prv_lfs.dirty) {
+        return 0;
+    }
+
+    int ret = fs_sync(&prv_lfs.file);
+
+    if (ret == 0) {
+        prv_lfs.dirty = false;
+    }
+
+    return ret;
+}
+
+/** @brief Commit buffered appends once the sync delay expires. */
+static void prv_lfs_sync_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    if (k_mutex_lock(prv_lfs.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS)) < 0) {
+        k_work_schedule(&prv_lfs.sync_work, K_MSEC(LOG_STORAGE_LFS_SYNC_MS));
+        return;
+    }
+
+    (void)prv_lfs_sync();
+
+    k_mutex_unlock(prv_lfs.lock);
+}
+
+/** @brief Create the log directory, find the stored segments and open a new one for this boot. */
+static int prv_lfs_init(struct k_mutex *lock)
+{
+    bool found;
+
+    if (prv_lfs.open) {
+        return 0;
+    }
+
+    prv_lfs.lock = lock;
+    k_work_init_delayable(&prv_lfs.sync_work, prv_lfs_sync_work_handler);
+
+    int ret = fs_mkdir(LOG_STORAGE_LFS_DIR);
+
+    if ((ret < 0) && (ret != -EEXIST)) {
+        LOG_ERR("Failed to create %s: %d", LOG_STORAGE_LFS_DIR, ret);
+        return ret;
+    }
+
+    ret = prv_lfs_scan(&found);
+    if (ret < 0) {
+        LOG_ERR("Failed to scan %s: %d", LOG_STORAGE_LFS_DIR, ret);
+        return ret;
+    }
+
+    if (!found) {
+        prv_lfs.oldest = 0U;
+        prv_lfs.current = 0U;
+    } else {
+        prv_lfs.current++;
+    }
+
+    ret = prv_lfs_start_segment(prv_lfs.current);
+    if (ret < 0) {
+        return ret;
+    }
+
+    return prv_lfs_prune(0U);
+}
+
+/** @brief Write to the current segment after pruning room for @p len bytes. Mutex must be held. */
+static int prv_lfs_write(const void *buf, size_t len)
+{
+    if (!prv_lfs.open) {
+        return -ENODEV;
+    }
+
+    int ret = prv_lfs_prune(len);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    ssize_t written = fs_write(&prv_lfs.file, buf, len);
+
+    if (written < 0) {
+        return (int)written;
+    }
+
+    prv_lfs.dirty = true;
+    prv_lfs.current_size += (uint32_t)written;
+    prv_lfs.used += (size_t)written;
+
+    return ((size_t)written == len) ? 0 : -ENOSPC;
+}
+
+/** @brief Append formatted log output and schedule (or, in panic mode, do) the commit. */
+static int prv_lfs_append(const void *buf, size_t len)
+{
+    int ret = k_mutex_lock(prv_lfs.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    uint32_t start_cycles = k_cycle_get_32();
+
+    ret = prv_lfs_write(buf, len);
+
+    if (ret == 0) {
+        uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+        prv_lfs.append_max_us = MAX(prv_lfs.append_max_us, us);
+
+        if (prv_lfs.panic_mode || (LOG_STORAGE_LFS_SYNC_MS == 0)) {
+            ret = prv_lfs_sync();
+        } else {
+            /* Keeps an already pending deadline, so a steady stream still syncs. */
+            k_work_schedule(&prv_lfs.sync_work, K_MSEC(LOG_STORAGE_LFS_SYNC_MS));
+        }
+    } else if ((ret == -ENOSPC) && prv_lfs.snapshot.active) {
+        /* Pruning would delete a segment the export has not read yet. */
+        prv_lfs.export_dropped++;
+    }
+
+    k_mutex_unlock(prv_lfs.lock);
+    return ret;
+}
+
+/** @brief Commit buffered appends now. */
+static int prv_lfs_flush(void)
+{
+    int ret = k_mutex_lock(prv_lfs.lock, K_MSEC(LOG_STORAGE_MUTEX_TIMEOUT_MS));
+
+    if (ret < 0) {
+        return -EBUSY;
+    }
+
+    ret = prv_lfs_sync();
+
+    k_mutex_unlock(prv_lfs.lock);
+    return ret;
+}
+
+/** @brief Switch to committing every append and commit what is buffered. */
+static int prv_lfs_panic(void)
+{
+    prv_lfs.panic_mode = true;
+
+    return prv_lfs_flush();
+}
+
+/** @brief Read from one segment; 0 bytes at its end or for a missing segment. */
+static int prv_lfs_read_segment(ovyl_log_storage_read_ctx_t *ctx, void *dst, size_t size, size_t *out_size)
+{
+    *out_size = 0U;
+
+    if ((ctx->segment < prv_lfs.oldest) || (ctx->segment > prv_lfs.current)) {
+        return 0;
+    }
+
+    if (ctx->segment == prv_lfs.current) {
+        if (ctx->offset >= prv_lfs.current_size) {
+            return 0;
+        }
+
+        /* Appends become visible to other handles once committed. */
+        int ret = prv_lfs_sync();
+
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    if (!prv_lfs.read_open || (prv_lfs.read_segment != ctx->segment)) {
+        char path[LOG_STORAGE_LFS_PATH_MAX];
+
+        prv_lfs_read_close();
+        prv_lfs_path(path, ctx->segment);
+        fs_file_t_init(&prv_lfs.read_file);
+
+        int ret = fs_open(&prv_lfs.read_file, path, FS_O_READ);
+
+        if (ret == -ENOENT) {
+            /* A boot that never got to create its file reads as empty. */
+            return 0;
+        }
+
+        if (ret < 0) {
+            return ret;
+        }
+
+        prv_lfs.read_open = true;
+        prv_lfs.read_segment = ctx->segment;
+    }
+
+    int ret = fs_seek(&prv_lfs.read_file, (off_t)ctx->offset, FS_SEEK_SET);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    ssize_t n = fs_read(&prv_lfs.read_file, dst, size);
+
+    if (n < 0) {
+        return (int)n;
+    }
+
+    ctx->offset += (uint32_t)n;
+    *out_size = (size_t)n;
+    return 0;
+}
+
+/**
+ * @brief Read the next bytes for @p ctx, crossing into later segments. Mutex must be held.
+ *
+ * Bounded reads stop at the snapshot end and keep the segment they reached
+ * from being pruned.
+ *
+ * @retval 0 Success; @p out_size is non-zero.
+ * @retval -ENOENT No additional data is available.
+ * @retval -EIO File system read failure.
+ */
+static int prv_lfs_read(ovyl_log_storage_read_ctx_t *ctx, bool bounded, void *dst, size_t size, size_t *out_size)
+{
+    ovyl_log_storage_lfs_snapshot_t *snap = &prv_lfs.snapshot;
+
+    *out_size = 0U;
+    bounded = bounded && snap->active;
+
+    if (!ctx->started || (ctx->segment < prv_lfs.oldest)) {
+        ctx->segment = prv_lfs.oldest;
+        ctx->offset = 0U;
+        ctx->started = true;
+    }
+
+    while (true) {
+        size_t want = size;
+
+        if (bounded) {
+            if ((ctx->segment > snap->end_segment) ||
+                ((ctx->segment == snap->end_segment) && (ctx->offset >= snap->end_offset))) {
+                return -ENOENT;
+            }
+
+            if (ctx->segment == snap->end_segment) {
+                want = MIN(want, snap->end_offset - ctx->offset);
+            }
+        }
+
+        int ret = prv_lfs_read_segment(ctx, dst, want, out_size);
+
+        if (ret < 0) {
+            LOG_ERR("Segment read failed: %d", ret);
+            return -EIO;
+        }
+
+        if (bounded) {
+            snap->pin = ctx->segment;
+        }
+
+        if (*out_size > 0U) {
+            return 0;
+        }
+
+        if (ctx->segment >= prv_lfs.current) {
+            return -ENOENT;
+        }
+
+        ctx->segment++;
+        ctx->offset = 0U;
+    }
+}
+
+/**
+ * @brief Fill @p dst across segments. Mutex must be held.
+ *
+ * The stream has no entries, so with OVYL_LOG_STORAGE_BULK_ENTRY_HDR the
+ * bytes returned by one call form a single entry.
+ */
+static int prv_lfs_read_bulk(ovyl_log_storage_read_ctx_t *ctx,
+                             bool bounded,
+                             uint8_t *dst,
+                             size_t dest_size,
+                             uint32_t flags,
+                             size_t *out_size)
+{
+    size_t hdr = ((flags & OVYL_LOG_STORAGE_BULK_ENTRY_HDR) != 0U) ? OVYL_LOG_STORAGE_BULK_HDR_SIZE : 0U;
+    size_t used = hdr;
+    int ret = 0;
+
+    *out_size = 0U;
+
+    if (dest_size <= hdr) {
+        return -EINVAL;
+    }
+
+    while (used < dest_size) {
+        size_t len;
+
+        ret = prv_lfs_read(ctx, bounded, &dst[used], dest_size - used, &len);
+        if (ret < 0) {
+            break;
+        }
+
+        used += len;
+    }
+
+    if (used == hdr) {
+        return ret;
+    }
+
+    if (hdr > 0U) {
+        sys_put_le16((uint16_t)(used - hdr), dst);
+    }
+
+    *out_size = used;
+    return ((ret == 0) || (ret == -ENOENT)) ? 0 : ret;
+}
+
+/** @brief Report the segment and offset a reader is at. */
+static int prv_lfs_position(const ovyl_log_storage_read_ctx_t *ctx, uint32_t *unit, uint32_t *offset)
+{
+    if (!ctx->started) {
+        return -ENOENT;
+    }
+
+    *unit = ctx->segment;
+    *offset = ctx->offset;
+    return 0;
+}
+
+/** @brief Capture the current end of data and pin the oldest segment. Mutex must be held. */
+static void prv_lfs_snapshot_begin(void)
+{
+    prv_lfs.snapshot.end_segment = prv_lfs.current;
+    prv_lfs.snapshot.end_offset = prv_lfs.current_size;
+    prv_lfs.snapshot.pin = prv_lfs.oldest;
+    prv_lfs.snapshot.active = true;
+}
+
+/** @brief Let pruning delete any segment again. Mutex must be held. */
+static void prv_lfs_snapshot_end(void)
+{
+    memset(&prv_lfs.snapshot, 0, sizeof(prv_lfs.snapshot));
+}
+
+/** @brief Pin the oldest segment again after the read head was rewound. Mutex must be held. */
+static void prv_lfs_snapshot_rewind(void)
+{
+    if (prv_lfs.snapshot.active) {
+        prv_lfs.snapshot.pin = prv_lfs.oldest;
+    }
+}
+
+/** @brief Delete every segment and continue in a new one. Mutex must be held. */
+static int prv_lfs_clear(void)
+{
+    char path[LOG_STORAGE_LFS_PATH_MAX];
+    uint32_t next = prv_lfs.current + 1U;
+    int ret = 0;
+
+    if (!prv_lfs.open) {
+        return -ENODEV;
+    }
+
+    prv_lfs_read_close();
+    (void)fs_close(&prv_lfs.file);
+    prv_lfs.open = false;
+
+    for (uint32_t segment = prv_lfs.oldest; segment != next; segment++) {
+        prv_lfs_path(path, segment);
+
+        int err = fs_unlink(path);
+
+        if ((err < 0) && (err != -ENOENT)) {
+            LOG_ERR("Failed to delete %s: %d", path, err);
+            ret = (ret == 0) ? err : ret;
+        }
+    }
+
+    prv_lfs.used = 0U;
+    prv_lfs.oldest = next;
+
+    int start_ret = prv_lfs_start_segment(next);
+
+    if (prv_lfs.snapshot.active) {
+        /* Nothing left to export; later reads stop immediately. */
+        prv_lfs_snapshot_begin();
+    }
+
+    return (ret < 0) ? ret : start_ret;
+}
+
+/** @brief Report the counters the backend keeps. Mutex must be held. */
+static void prv_lfs_get_stats(ovyl_log_storage_stats_t *stats)
+{
+    stats->append_max_us_inline = prv_lfs.append_max_us;
+    stats->export_dropped = prv_lfs.export_dropped;
+}
+
+/** @brief Zero the counters the backend keeps. Mutex must be held. */
+static void prv_lfs_reset_stats(void)
+{
+    prv_lfs.append_max_us = 0U;
+    prv_lfs.export_dropped = 0U;
+}
+
+#ifdef CONFIG_SHELL
+/** @brief Print the LittleFS part of "log_storage stats". Mutex must be held. */
+static void prv_lfs_shell_stats(const struct shell *sh, const ovyl_log_storage_stats_t *stats)
+{
+    shell_print(sh, "Storage:               %u of %u bytes", (uint32_t)prv_lfs.used, (uint32_t)LOG_STORAGE_LFS_MAX_SIZE);
+    shell_print(sh, "Segments:              %u .. %u (current %u bytes)",
+                prv_lfs.oldest,
+                prv_lfs.current,
+                prv_lfs.current_size);
+    shell_print(sh, "Append latency (worst case): %u us", stats->append_max_us_inline);
+}
+#endif
+
+const ovyl_log_storage_backend_api_t ovyl_log_storage_backend_littlefs = {
+    .unit = "segment",
+    .init = prv_lfs_init,
+    .append = prv_lfs_append,
+    .flush = prv_lfs_flush,
+    .panic = prv_lfs_panic,
+    .sync = prv_lfs_sync,
+    .read = prv_lfs_read,
+    .read_bulk = prv_lfs_read_bulk,
+    .position = prv_lfs_position,
+    .snapshot_begin = prv_lfs_snapshot_begin,
+    .snapshot_end = prv_lfs_snapshot_end,
+    .snapshot_rewind = prv_lfs_snapshot_rewind,
+    .clear = prv_lfs_clear,
+    .get_stats = prv_lfs_get_stats,
+    .reset_stats = prv_lfs_reset_stats,
+#ifdef CONFIG_SHELL
+    .shell_stats = prv_lfs_shell_stats,
+#endif
+};
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_ring.c
+ * @brief Lock-free multi-producer ring queuing log output for the async writer.
+ */
+
+#include "log_storage_ring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+
+#define LOG_STORAGE_RING_MASK (OVYL_LOG_STORAGE_RING_SLOTS - 1U)
+/* Bounded attempts to make room under drop-oldest before giving up on the new data. */
+#define LOG_STORAGE_RING_DROP_RETRIES (4U)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(OVYL_LOG_STORAGE_RING_SLOTS), "Ring slot count must be a power of two");
+
+/** @brief Signed distance between two ring positions, tolerant of counter wrap. */
+static int32_t prv_ring_diff(atomic_val_t a, atomic_val_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+/** @brief Track the maximum number of slots in use. */
+static void prv_ring_update_high_water(ovyl_log_storage_ring_t *ring)
+{
+    atomic_val_t used = prv_ring_diff(atomic_get(&ring->enqueue_pos), atomic_get(&ring->dequeue_pos));
+    atomic_val_t hwm = atomic_get(&ring->high_water);
+
+    while (used > hwm) {
+        if (atomic_cas(&ring->high_water, hwm, used)) {
+            break;
+        }
+        hwm = atomic_get(&ring->high_water);
+    }
+}
+
+/** @brief Reserve consecutive slots for a whole message and copy it in without blocking. */
+static int prv_ring_push_msg(ovyl_log_storage_ring_t *ring, const uint8_t *data, size_t len)
+{
+    uint32_t count = DIV_ROUND_UP(len, OVYL_LOG_STORAGE_RING_SLOT_SIZE);
+    atomic_val_t pos = atomic_get(&ring->enqueue_pos);
+
+    while (true) {
+        int32_t diff = 0;
+
+        for (uint32_t k = 0; (k < count) && (diff == 0); k++) {
+            diff = prv_ring_diff(atomic_get(&ovyl_log_storage_ring_slot(ring, pos + k)->seq), pos + k);
+        }
+
+        if (diff == 0) {
+            if (atomic_cas(&ring->enqueue_pos, pos, pos + count)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -ENOMEM;
+        }
+
+        pos = atomic_get(&ring->enqueue_pos);
+    }
+
+    for (uint32_t k = 0; k < count; k++) {
+        ovyl_log_storage_ring_slot_t *slot = ovyl_log_storage_ring_slot(ring, pos + k);
+        size_t chunk = MIN(len, (size_t)OVYL_LOG_STORAGE_RING_SLOT_SIZE);
+
+        memcpy(slot->data, data, chunk);
+        slot->len = (uint16_t)chunk;
+        slot->count = (uint16_t)count;
+        atomic_set(&slot->seq, pos + k + 1);
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+void ovyl_log_storage_ring_init(ovyl_log_storage_ring_t *ring)
+{
+    for (uint32_t i = 0; i < OVYL_LOG_STORAGE_RING_SLOTS; i++) {
+        atomic_set(&ring->slots[i].seq, (atomic_val_t)i);
+    }
+
+    atomic_set(&ring->enqueue_pos, 0);
+    atomic_set(&ring->dequeue_pos, 0);
+    atomic_set(&ring->dropped, 0);
+    atomic_set(&ring->high_water, 0);
+}
+
+int ovyl_log_storage_ring_push(ovyl_log_storage_ring_t *ring, const void *buf, size_t len)
+{
+    if (len == 0U) {
+        return 0;
+    }
+
+    if (DIV_ROUND_UP(len, OVYL_LOG_STORAGE_RING_SLOT_SIZE) > OVYL_LOG_STORAGE_RING_SLOTS) {
+        /* Evicting queued messages could never make room for this one. */
+        atomic_inc(&ring->dropped);
+        return -EMSGSIZE;
+    }
+
+    int ret = prv_ring_push_msg(ring, buf, len);
+
+#ifdef CONFIG_OVYL_LOG_STORAGE_ASYNC_DROP_OLDEST
+    for (uint32_t i = 0; (ret == -ENOMEM) && (i < LOG_STORAGE_RING_DROP_RETRIES); i++) {
+        atomic_val_t pos;
+        uint32_t count;
+
+        if (ovyl_log_storage_ring_claim(ring, &pos, &count)) {
+            ovyl_log_storage_ring_release(ring, pos, count);
+            atomic_inc(&ring->dropped);
+        }
+
+        ret = prv_ring_push_msg(ring, buf, len);
+    }
+#endif
+
+    if (ret < 0) {
+        atomic_inc(&ring->dropped);
+    }
+
+    prv_ring_update_high_water(ring);
+
+    return ret;
+}
+
+bool ovyl_log_storage_ring_claim(ovyl_log_storage_ring_t *ring, atomic_val_t *pos, uint32_t *count)
+{
+    atomic_val_t cur = atomic_get(&ring->dequeue_pos);
+
+    while (true) {
+        ovyl_log_storage_ring_slot_t *slot = ovyl_log_storage_ring_slot(ring, cur);
+        int32_t diff = prv_ring_diff(atomic_get(&slot->seq), cur + 1);
+
+        if (diff == 0) {
+            uint32_t n = slot->count;
+
+            for (uint32_t k = 1; (k < n) && (diff == 0); k++) {
+                diff = prv_ring_diff(atomic_get(&ovyl_log_storage_ring_slot(ring, cur + k)->seq), cur + k + 1);
+            }
+
+            if ((diff == 0) && atomic_cas(&ring->dequeue_pos, cur, cur + n)) {
+                *pos = cur;
+                *count = n;
+                return true;
+            }
+        }
+
+        if (diff < 0) {
+            return false;
+        }
+
+        cur = atomic_get(&ring->dequeue_pos);
+    }
+}
+
+ovyl_log_storage_ring_slot_t *ovyl_log_storage_ring_slot(ovyl_log_storage_ring_t *ring, atomic_val_t pos)
+{
+    return &ring->slots[(uint32_t)pos & LOG_STORAGE_RING_MASK];
+}
+
+void ovyl_log_storage_ring_release(ovyl_log_storage_ring_t *ring, atomic_val_t pos, uint32_t count)
+{
+    for (uint32_t k = 0; k < count; k++) {
+        atomic_set(&ovyl_log_storage_ring_slot(ring, pos + k)->seq, pos + k + OVYL_LOG_STORAGE_RING_SLOTS);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file log_storage_ring.h
+ * @brief Lock-free multi-producer ring queuing log output for the async writer.
+ *
+ * Producers copy a message into consecutive slots without blocking and
+ * consumers claim it back as a whole. The ring knows nothing about storage,
+ * so it carries no thread or semaphore; the owner wakes its consumer.
+ */
+
+#ifndef OVYL_LOG_STORAGE_RING_H
+#define OVYL_LOG_STORAGE_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/sys/atomic.h>
+
+/** @brief Number of slots in the ring; a power of two. */
+#define OVYL_LOG_STORAGE_RING_SLOTS CONFIG_OVYL_LOG_STORAGE_ASYNC_RING_SLOTS
+
+/** @brief Payload bytes per slot. */
+#define OVYL_LOG_STORAGE_RING_SLOT_SIZE CONFIG_OVYL_LOG_STORAGE_ASYNC_SLOT_SIZE
+
+/**
+ * @brief Single slot in the producer ring.
+ *
+ * @c seq implements a bounded MPMC sequence protocol: a slot is free for the
+ * producer at position @c pos when @c seq == pos, and holds committed data for
+ * the consumer at position @c pos when @c seq == pos + 1.
+ */
+typedef struct {
+    atomic_t seq;
+    uint16_t len;
+    uint16_t count; /**< Slots in the message; only meaningful on its first slot. */
+    uint8_t data[OVYL_LOG_STORAGE_RING_SLOT_SIZE];
+} ovyl_log_storage_ring_slot_t;
+
+/** @brief Lock-free multi-producer ring. */
+typedef struct {
+    ovyl_log_storage_ring_slot_t slots[OVYL_LOG_STORAGE_RING_SLOTS];
+    atomic_t enqueue_pos;
+    atomic_t dequeue_pos;
+    atomic_t dropped;    /**< Messages discarded by the overflow policy. */
+    atomic_t high_water; /**< Most slots in use at once. */
+} ovyl_log_storage_ring_t;
+
+/** @brief Reset @p ring to empty and zero its counters. */
+void ovyl_log_storage_ring_init(ovyl_log_storage_ring_t *ring);
+
+/**
+ * @brief Queue @p len bytes as one message, applying the overflow policy.
+ *
+ * Never blocks. With OVYL_LOG_STORAGE_ASYNC_DROP_OLDEST the oldest queued
+ * messages are discarded to make room; otherwise the new message is. Every
+ * discarded message is counted in @c dropped.
+ *
+ * @retval 0 The message was queued, or @p len is 0.
+ * @retval -ENOMEM The ring is full and the message was dropped.
+ * @retval -EMSGSIZE The message needs more slots than the ring has.
+ */
+int ovyl_log_storage_ring_push(ovyl_log_storage_ring_t *ring, const void *buf, size_t len);
+
+/**
+ * @brief Claim the oldest committed message for reading.
+ *
+ * A message occupies consecutive slots and is claimed as a whole, so a reader
+ * never sees part of one. Safe to call from several contexts at once.
+ *
+ * @param ring Ring to read from.
+ * @param pos Populated with the ring position of the message's first slot.
+ * @param count Populated with the number of slots the message occupies.
+ * @retval true A message was claimed; release it with ovyl_log_storage_ring_release().
+ * @retval false The ring is empty or its oldest message is still being copied in.
+ */
+bool ovyl_log_storage_ring_claim(ovyl_log_storage_ring_t *ring, atomic_val_t *pos, uint32_t *count);
+
+/** @brief Slot backing ring position @p pos. */
+ovyl_log_storage_ring_slot_t *ovyl_log_storage_ring_slot(ovyl_log_storage_ring_t *ring, atomic_val_t pos);
+
+/** @brief Hand the @p count slots of a claimed message back to producers. */
+void ovyl_log_storage_ring_release(ovyl_log_storage_ring_t *ring, atomic_val_t pos, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVYL_LOG_STORAGE_RING_H */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file main.c
+ * @brief Round-trip tests of the LZSS codec used for compressed log entries.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+
+#include "log_compress.h"
+
+#define WINDOW CONFIG_OVYL_LOG_STORAGE_COMPRESS_WINDOW
+#define MAX_INPUT (MAX(WINDOW, 1024U) + 64U)
+#define TAIL_LEN (32U)
+
+static ovyl_log_compress_ctx_t test_ctx;
+static uint8_t test_src[MAX_INPUT];
+static uint8_t test_enc[OVYL_LOG_COMPRESS_BOUND(MAX_INPUT)];
+static uint8_t test_dec[MAX_INPUT];
+
+/** @brief Fill @p buf with reproducible bytes that do not compress. */
+static void prv_random(uint8_t *buf, size_t len, uint32_t seed)
+{
+    uint32_t x = seed;
+
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = (uint8_t)x;
+    }
+}
+
+/** @brief Fill @p buf with formatted log lines, as the staging buffer holds them. */
+static size_t prv_log_lines(uint8_t *buf, size_t size)
+{
+    size_t len = 0U;
+
+    for (uint32_t i = 0; len < size; i++) {
+        char line[64];
+        int n = snprintf(line, sizeof(line), "[%08u] <inf> sensor: sample %u value %u\n", i * 250U, i, i % 7U);
+
+        n = MIN((size_t)n, size - len);
+        memcpy(&buf[len], line, n);
+        len += n;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Encode @p len bytes of test_src, decode them again and compare.
+ *
+ * @return Encoded length.
+ */
+static size_t prv_round_trip(size_t len)
+{
+    size_t enc_len = ovyl_log_compress_encode(&test_ctx, test_src, len, test_enc, sizeof(test_enc));
+    size_t dec_len = 0U;
+
+    zassert_true(enc_len > 0U, "encode of %zu bytes failed", len);
+    zassert_true(enc_len <= OVYL_LOG_COMPRESS_BOUND(len), "encoded %zu bytes past the bound", enc_len);
+
+    memset(test_dec, 0, sizeof(test_dec));
+    zassert_ok(ovyl_log_compress_decode(test_enc, enc_len, test_dec, sizeof(test_dec), &dec_len), "decode failed");
+    zassert_equal(dec_len, len, "decoded length differs");
+    zassert_mem_equal(test_dec, test_src, len, "decoded bytes differ");
+
+    return enc_len;
+}
+
+ZTEST(log_compress, test_log_lines)
+{
+    size_t len = prv_log_lines(test_src, MIN(sizeof(test_src), 1024U));
+    size_t enc_len = prv_round_trip(len);
+
+    zassert_true(enc_len < (len / 2U), "log lines compressed to %zu of %zu bytes", enc_len, len);
+}
+
+ZTEST(log_compress, test_incompressible)
+{
+    prv_random(test_src, sizeof(test_src), 0x1234567U);
+
+    size_t enc_len = prv_round_trip(sizeof(test_src));
+
+    zassert_true(enc_len > sizeof(test_src), "random data should only grow");
+}
+
+ZTEST(log_compress, test_run)
+{
+    /* Overlapping matches replicate a single byte. */
+    memset(test_src, 'A', sizeof(test_src));
+
+    size_t enc_len = prv_round_trip(sizeof(test_src));
+
+    zassert_true(enc_len < (sizeof(test_src) / 4U), "run compressed to %zu bytes", enc_len);
+}
+
+ZTEST(log_compress, test_short_inputs)
+{
+    for (size_t len = 1U; len <= 20U; len++) {
+        memcpy(test_src, "abcabcabcabcabcabcabc", len);
+        (void)prv_round_trip(len);
+    }
+}
+
+ZTEST(log_compress, test_window_edge)
+{
+    size_t len = WINDOW + TAIL_LEN;
+
+    /* The tail repeats the head of the buffer exactly one window back. */
+    memset(test_src, 0, sizeof(test_src));
+    prv_random(test_src, TAIL_LEN, 0xC0FFEEU);
+    memcpy(&test_src[WINDOW], test_src, TAIL_LEN);
+
+    size_t in_window = prv_round_trip(len);
+
+    /* One byte further back the repeat is out of reach. */
+    memmove(&test_src[TAIL_LEN + 1U], &test_src[TAIL_LEN], len - TAIL_LEN);
+    test_src[TAIL_LEN] = 0U;
+
+    size_t out_of_window = prv_round_trip(len + 1U);
+
+    zassert_true((in_window + (TAIL_LEN / 2U)) < out_of_window,
+                 "match at the window edge not used (%zu vs %zu bytes)",
+                 in_window,
+                 out_of_window);
+}
+
+ZTEST(log_compress, test_ctx_reuse)
+{
+    size_t len = prv_log_lines(test_src, 256U);
+
+    (void)prv_round_trip(len);
+
+    /* Match positions left from the first buffer must not leak into the second. */
+    prv_random(test_src, 256U, 42U);
+    memcpy(&test_src[256], "[00000000] <inf> sensor: ", 25U);
+    (void)prv_round_trip(281U);
+}
+
+ZTEST(log_compress, test_encode_no_room)
+{
+    size_t len = prv_log_lines(test_src, 512U);
+    size_t enc_len = prv_round_trip(len);
+
+    zassert_equal(ovyl_log_compress_encode(&test_ctx, test_src, len, test_enc, enc_len - 1U),
+                  0U,
+                  "encode overran its output buffer");
+    zassert_equal(ovyl_log_compress_encode(&test_ctx, test_src, 0x10000U, test_enc, sizeof(test_enc)),
+                  0U,
+                  "input past the 16-bit position limit accepted");
+}
+
+ZTEST(log_compress, test_decode_no_room)
+{
+    size_t len = prv_log_lines(test_src, 512U);
+    size_t enc_len = prv_round_trip(len);
+    size_t dec_len;
+
+    zassert_equal(ovyl_log_compress_decode(test_enc, enc_len, test_dec, len - 1U, &dec_len),
+                  -EINVAL,
+                  "decode overran its output buffer");
+}
+
+ZTEST(log_compress, test_decode_corrupt)
+{
+    /* A match before any output, and a match cut short. */
+    static const uint8_t before_start[] = {0x01U, 0x00U, 0x00U};
+    static const uint8_t truncated[] = {0x02U, 'a', 0x00U};
+    size_t dec_len;
+
+    zassert_equal(ovyl_log_compress_decode(before_start, sizeof(before_start), test_dec, sizeof(test_dec), &dec_len),
+                  -EINVAL,
+                  "match before the start accepted");
+    zassert_equal(ovyl_log_compress_decode(truncated, sizeof(truncated), test_dec, sizeof(test_dec), &dec_len),
+                  -EINVAL,
+                  "truncated match accepted");
+}
+
+ZTEST_SUITE(log_compress, NULL, NULL, NULL, NULL, NULL);
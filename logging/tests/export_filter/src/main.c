@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file main.c
+ * @brief Tests of the export record filter, built for one stored record format.
+ *
+ * Each test builds a stream of records, marks which of them the filter has to
+ * keep and checks the filter output byte for byte, fed in one piece, in
+ * chunks of every size and in place the way the export loop runs it.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/sys/byteorder.h>
+#ifdef CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY
+#include <zephyr/logging/log_output_dict.h>
+#endif
+
+#include <ovyl/log_storage.h>
+
+#include "log_storage_export.h"
+#include "log_storage_level.h"
+
+LOG_MODULE_REGISTER(filter_test, LOG_LEVEL_INF);
+
+#define STREAM_SIZE (1024U)
+/* Text lines name their module; binary records carry the source id. */
+#define KEPT_MODULE "filter_test"
+#define OTHER_MODULE "filter_other"
+#define SRC_OTHER (5U)
+
+static uint8_t test_in[STREAM_SIZE];
+static uint8_t test_expect[STREAM_SIZE];
+static uint8_t test_out[STREAM_SIZE + OVYL_LOG_STORAGE_FILTER_HDR_MAX];
+static size_t test_in_len;
+static size_t test_expect_len;
+static ovyl_log_storage_filter_t test_filter;
+
+#if !defined(CONFIG_OVYL_LOG_STORAGE_RECORD_HDR) && !defined(CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY)
+/*
+ * log_storage_level.c also persists levels through Ovyl Config; the text
+ * filter only needs its level names.
+ */
+int ovyl_log_storage_level_parse(const char *name, uint8_t *level)
+{
+    static const char *const names[] = {"off", "err", "wrn", "inf", "dbg"};
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(names); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *level = i;
+            return 0;
+        }
+    }
+
+    return -EINVAL;
+}
+#endif
+
+/** @brief Source id the filter selects; the module registered by this file. */
+static uint16_t prv_kept_source(void)
+{
+    return (uint16_t)log_source_id_get(KEPT_MODULE);
+}
+
+/**
+ * @brief Encode one record as the storage backend writes it.
+ *
+ * @return Record length in bytes.
+ */
+static size_t prv_encode(uint8_t *buf, size_t size, uint8_t level, bool kept_source, const char *msg)
+{
+#if defined(CONFIG_OVYL_LOG_STORAGE_RECORD_HDR)
+    size_t msg_len = strlen(msg);
+
+    ARG_UNUSED(size);
+
+    buf[0] = OVYL_LOG_STORAGE_RECORD_SYNC;
+    buf[1] = level;
+    sys_put_le16(kept_source ? prv_kept_source() : SRC_OTHER, &buf[2]);
+    sys_put_le16(1U, &buf[4]);
+    sys_put_le16((uint16_t)msg_len, &buf[6]);
+    sys_put_le32((uint32_t)test_in_len, &buf[8]);
+    sys_put_le64(1000U, &buf[12]);
+    memcpy(&buf[OVYL_LOG_STORAGE_RECORD_HDR_SIZE], msg, msg_len);
+
+    return OVYL_LOG_STORAGE_RECORD_HDR_SIZE + msg_len;
+#elif defined(CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY)
+    size_t msg_len = strlen(msg);
+    struct log_dict_output_normal_msg_hdr_t hdr = {
+        .type = MSG_NORMAL,
+        .level = level,
+        .package_len = (uint32_t)msg_len,
+        .source = kept_source ? prv_kept_source() : SRC_OTHER,
+    };
+
+    ARG_UNUSED(size);
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    memcpy(&buf[sizeof(hdr)], msg, msg_len);
+
+    return sizeof(hdr) + msg_len;
+#else
+    static const char *const names[] = {"off", "err", "wrn", "inf", "dbg"};
+
+    return (size_t)snprintf((char *)buf,
+                            size,
+                            "[00001000] <%s> %s: %s\n",
+                            names[level],
+                            kept_source ? KEPT_MODULE : OTHER_MODULE,
+                            msg);
+#endif
+}
+
+/** @brief Append raw bytes to the stream, and to the expected output when @p kept. */
+static void prv_add_raw(const void *data, size_t len, bool kept)
+{
+    zassert_true(test_in_len + len <= STREAM_SIZE, "stream too long");
+
+    if (kept) {
+        memcpy(&test_expect[test_expect_len], data, len);
+        test_expect_len += len;
+    }
+
+    memcpy(&test_in[test_in_len], data, len);
+    test_in_len += len;
+}
+
+/** @brief Append one record to the stream, and to the expected output when @p kept. */
+static void prv_add(uint8_t level, bool kept_source, const char *msg, bool kept)
+{
+    uint8_t record[128];
+    size_t len = prv_encode(record, sizeof(record), level, kept_source, msg);
+
+    prv_add_raw(record, len, kept);
+}
+
+/** @brief Run the whole stream through a fresh filter in chunks of at most @p chunk bytes. */
+static size_t prv_run(size_t chunk, uint8_t *out)
+{
+    ovyl_log_storage_export_filter_t f;
+    size_t n = 0U;
+
+    ovyl_log_storage_filter_begin(&f, &test_filter);
+
+    for (size_t i = 0; i < test_in_len; i += chunk) {
+        n += ovyl_log_storage_filter_records(&f, &out[n], &test_in[i], MIN(chunk, test_in_len - i));
+    }
+
+    n += ovyl_log_storage_filter_finish(&f, &out[n]);
+    return n;
+}
+
+/** @brief Check the output against the expected records for every chunk size. */
+static void prv_check(void)
+{
+    for (size_t chunk = 1U; chunk <= test_in_len; chunk++) {
+        memset(test_out, 0, sizeof(test_out));
+
+        size_t n = prv_run(chunk, test_out);
+
+        zassert_equal(n, test_expect_len, "kept %zu bytes instead of %zu with %zu byte chunks", n, test_expect_len, chunk);
+        zassert_mem_equal(test_out, test_expect, n, "wrong bytes kept with %zu byte chunks", chunk);
+    }
+}
+
+static void filter_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    memset(&test_filter, 0, sizeof(test_filter));
+    test_in_len = 0U;
+    test_expect_len = 0U;
+}
+
+ZTEST(log_storage_export_filter, test_no_filter)
+{
+    prv_add(LOG_LEVEL_ERR, true, "boot failed", true);
+    prv_add(LOG_LEVEL_DBG, false, "tick", true);
+    prv_add(LOG_LEVEL_INF, true, "ready", true);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_level)
+{
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_WRN;
+
+    prv_add(LOG_LEVEL_DBG, true, "tick", false);
+    prv_add(LOG_LEVEL_ERR, true, "boot failed", true);
+    prv_add(LOG_LEVEL_INF, false, "ready", false);
+    prv_add(LOG_LEVEL_WRN, false, "battery low", true);
+    prv_add(LOG_LEVEL_DBG, false, "tock", false);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_source)
+{
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_SOURCE;
+    test_filter.sources[0] = prv_kept_source();
+    test_filter.source_cnt = 1U;
+
+    prv_add(LOG_LEVEL_INF, false, "radio on", false);
+    prv_add(LOG_LEVEL_DBG, true, "sample 1", true);
+    prv_add(LOG_LEVEL_ERR, false, "radio failed", false);
+    prv_add(LOG_LEVEL_INF, true, "sample 2", true);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_level_and_source)
+{
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL | OVYL_LOG_STORAGE_FILTER_SOURCE;
+    test_filter.max_level = LOG_LEVEL_INF;
+    test_filter.sources[0] = prv_kept_source();
+    test_filter.source_cnt = 1U;
+
+    prv_add(LOG_LEVEL_DBG, true, "sample 1", false);
+    prv_add(LOG_LEVEL_INF, true, "sample 2", true);
+    prv_add(LOG_LEVEL_ERR, false, "radio failed", false);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_in_place)
+{
+    /* The export loop reads each chunk behind the output, in the same buffer. */
+    static uint8_t work[OVYL_LOG_STORAGE_FILTER_HDR_MAX + 48U];
+    const size_t chunk = sizeof(work) - OVYL_LOG_STORAGE_FILTER_HDR_MAX;
+    ovyl_log_storage_export_filter_t f;
+    size_t n = 0U;
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_INF;
+
+    for (uint8_t i = 0; i < 8U; i++) {
+        prv_add((i % 2U) ? LOG_LEVEL_DBG : LOG_LEVEL_INF, true, "a message long enough to span chunks", (i % 2U) == 0U);
+    }
+
+    ovyl_log_storage_filter_begin(&f, &test_filter);
+
+    for (size_t i = 0; i < test_in_len; i += chunk) {
+        size_t len = MIN(chunk, test_in_len - i);
+
+        memcpy(&work[OVYL_LOG_STORAGE_FILTER_HDR_MAX], &test_in[i], len);
+
+        size_t kept = ovyl_log_storage_filter_records(&f, work, &work[OVYL_LOG_STORAGE_FILTER_HDR_MAX], len);
+
+        memcpy(&test_out[n], work, kept);
+        n += kept;
+    }
+
+    n += ovyl_log_storage_filter_finish(&f, &test_out[n]);
+
+    zassert_equal(n, test_expect_len, "kept %zu bytes instead of %zu", n, test_expect_len);
+    zassert_mem_equal(test_out, test_expect, n, "wrong bytes kept");
+}
+
+#if defined(CONFIG_OVYL_LOG_STORAGE_RECORD_HDR)
+ZTEST(log_storage_export_filter, test_continuation)
+{
+    uint8_t record[64];
+    size_t len;
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_WRN;
+
+    /* Continuations of a long message follow its first record, whatever their own level. */
+    prv_add(LOG_LEVEL_ERR, true, "first part", true);
+    len = prv_encode(record, sizeof(record), LOG_LEVEL_DBG, true, "second part");
+    record[1] |= OVYL_LOG_STORAGE_RECORD_CONT << 3;
+    prv_add_raw(record, len, true);
+
+    prv_add(LOG_LEVEL_DBG, true, "first part", false);
+    len = prv_encode(record, sizeof(record), LOG_LEVEL_ERR, true, "second part");
+    record[1] |= OVYL_LOG_STORAGE_RECORD_CONT << 3;
+    prv_add_raw(record, len, false);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_no_source)
+{
+    uint8_t record[64];
+    size_t len;
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_SOURCE;
+    test_filter.sources[0] = prv_kept_source();
+    test_filter.source_cnt = 1U;
+
+    /* Data added directly has no log source and is always kept. */
+    len = prv_encode(record, sizeof(record), LOG_LEVEL_INF, false, "raw data");
+    sys_put_le16(OVYL_LOG_STORAGE_RECORD_NO_SOURCE, &record[2]);
+    prv_add_raw(record, len, true);
+    prv_add(LOG_LEVEL_INF, false, "radio on", false);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_resync)
+{
+    /* Bytes from before record headers, including a false sync byte, are skipped. */
+    static const uint8_t junk[] = {'o', 'l', 'd', OVYL_LOG_STORAGE_RECORD_SYNC, 0x07U, '\n'};
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_DBG;
+
+    prv_add_raw(junk, sizeof(junk), false);
+    prv_add(LOG_LEVEL_INF, true, "ready", true);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_hdr_decode)
+{
+    uint8_t record[64];
+    ovyl_log_storage_record_hdr_t hdr;
+
+    (void)prv_encode(record, sizeof(record), LOG_LEVEL_WRN, false, "battery low");
+    zassert_ok(ovyl_log_storage_record_hdr_decode(record, &hdr), "valid header rejected");
+    zassert_equal(hdr.level, LOG_LEVEL_WRN, "wrong level");
+    zassert_equal(hdr.source_id, SRC_OTHER, "wrong source");
+    zassert_equal(hdr.boot_id, 1U, "wrong boot id");
+    zassert_equal(hdr.len, strlen("battery low"), "wrong length");
+    zassert_equal(hdr.timestamp, 1000U, "wrong timestamp");
+
+    record[1] = 0x07U;
+    zassert_equal(ovyl_log_storage_record_hdr_decode(record, &hdr), -EINVAL, "level past DBG accepted");
+    record[1] = LOG_LEVEL_WRN | (0x02U << 3);
+    zassert_equal(ovyl_log_storage_record_hdr_decode(record, &hdr), -EINVAL, "unknown flag accepted");
+    record[1] = LOG_LEVEL_WRN;
+    sys_put_le16(CONFIG_OVYL_LOG_STORAGE_BUFFER_SIZE + 1U, &record[6]);
+    zassert_equal(ovyl_log_storage_record_hdr_decode(record, &hdr), -EINVAL, "oversize record accepted");
+}
+#elif defined(CONFIG_OVYL_LOG_STORAGE_FORMAT_DICTIONARY)
+ZTEST(log_storage_export_filter, test_dropped_notice)
+{
+    struct log_dict_output_dropped_msg_t dropped = {
+        .type = MSG_DROPPED_MSG,
+        .num_dropped_messages = 3U,
+    };
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_ERR;
+
+    prv_add(LOG_LEVEL_DBG, true, "tick", false);
+    prv_add_raw(&dropped, sizeof(dropped), true);
+    prv_add(LOG_LEVEL_ERR, true, "boot failed", true);
+
+    prv_check();
+}
+#else
+ZTEST(log_storage_export_filter, test_continuation)
+{
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_WRN;
+
+    /* Lines that do not start a record (hexdumps, multi-line messages) follow the record. */
+    prv_add(LOG_LEVEL_ERR, true, "dump\n 00 01 02 03", true);
+    prv_add(LOG_LEVEL_DBG, true, "dump\n 04 05 06 07", false);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_dropped_notice)
+{
+    static const char dropped[] = "--- 3 messages dropped ---\n";
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_ERR;
+
+    prv_add(LOG_LEVEL_DBG, true, "tick", false);
+    prv_add_raw(dropped, strlen(dropped), true);
+    prv_add(LOG_LEVEL_ERR, true, "boot failed", true);
+
+    prv_check();
+}
+
+ZTEST(log_storage_export_filter, test_finish)
+{
+    /* An export can end inside a line prefix; finish() decides on what it holds. */
+    static const char partial[] = "[00001000] <err>";
+
+    test_filter.flags = OVYL_LOG_STORAGE_FILTER_LEVEL;
+    test_filter.max_level = LOG_LEVEL_WRN;
+
+    prv_add(LOG_LEVEL_INF, true, "ready", false);
+    prv_add_raw(partial, strlen(partial), true);
+
+    prv_check();
+}
+#endif
+
+ZTEST_SUITE(log_storage_export_filter, NULL, NULL, filter_before, NULL, NULL);
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2025 Ovyl
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file main.c
+ * @brief Tests of the producer ring behind the async log writer.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+
+#include "log_storage_ring.h"
+
+#define RING_SLOTS OVYL_LOG_STORAGE_RING_SLOTS
+#define SLOT_SIZE OVYL_LOG_STORAGE_RING_SLOT_SIZE
+#define RING_BYTES (RING_SLOTS * SLOT_SIZE)
+
+static ovyl_log_storage_ring_t test_ring;
+
+/** @brief Fill @p buf with a pattern that differs per @p seed. */
+static void prv_pattern(uint8_t *buf, size_t len, uint8_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seed + (i * 7U));
+    }
+}
+
+/** @brief Place both ring positions at @p pos, as if that many slots had been used already. */
+static void prv_ring_start_at(atomic_val_t pos)
+{
+    for (uint32_t k = 0; k < RING_SLOTS; k++) {
+        atomic_set(&ovyl_log_storage_ring_slot(&test_ring, pos + k)->seq, pos + k);
+    }
+
+    atomic_set(&test_ring.enqueue_pos, pos);
+    atomic_set(&test_ring.dequeue_pos, pos);
+}
+
+/**
+ * @brief Claim the oldest message, copy it out and release it.
+ *
+ * @return Message length, or -1 when nothing could be claimed.
+ */
+static int prv_pop(uint8_t *dst, size_t size)
+{
+    atomic_val_t pos;
+    uint32_t count;
+    size_t len = 0U;
+
+    if (!ovyl_log_storage_ring_claim(&test_ring, &pos, &count)) {
+        return -1;
+    }
+
+    for (uint32_t k = 0; k < count; k++) {
+        ovyl_log_storage_ring_slot_t *slot = ovyl_log_storage_ring_slot(&test_ring, pos + k);
+
+        zassert_true(len + slot->len <= size, "message larger than the test buffer");
+        zassert_equal(slot->count, count, "slot %u disagrees on the message size", k);
+        memcpy(&dst[len], slot->data, slot->len);
+        len += slot->len;
+    }
+
+    ovyl_log_storage_ring_release(&test_ring, pos, count);
+    return (int)len;
+}
+
+/** @brief Pop one message and check it holds @p len bytes of the pattern for @p seed. */
+static void prv_expect(size_t len, uint8_t seed)
+{
+    uint8_t expected[RING_BYTES];
+    uint8_t got[RING_BYTES];
+
+    prv_pattern(expected, len, seed);
+    zassert_equal(prv_pop(got, sizeof(got)), (int)len, "wrong message length");
+    zassert_mem_equal(got, expected, len, "message %u corrupted", seed);
+}
+
+/** @brief Push @p len bytes of the pattern for @p seed. */
+static int prv_push(size_t len, uint8_t seed)
+{
+    uint8_t buf[RING_BYTES + 1];
+
+    prv_pattern(buf, len, seed);
+    return ovyl_log_storage_ring_push(&test_ring, buf, len);
+}
+
+static void ring_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    ovyl_log_storage_ring_init(&test_ring);
+}
+
+ZTEST(log_storage_ring, test_empty)
+{
+    uint8_t buf[SLOT_SIZE];
+
+    zassert_equal(prv_pop(buf, sizeof(buf)), -1, "empty ring returned a message");
+    zassert_ok(ovyl_log_storage_ring_push(&test_ring, buf, 0U), "empty message rejected");
+    zassert_equal(prv_pop(buf, sizeof(buf)), -1, "empty message was queued");
+}
+
+ZTEST(log_storage_ring, test_single_slot)
+{
+    zassert_ok(prv_push(5U, 1U), "push failed");
+    prv_expect(5U, 1U);
+    zassert_equal(prv_pop(NULL, 0U), -1, "message read twice");
+}
+
+ZTEST(log_storage_ring, test_multi_slot)
+{
+    size_t len = (2U * SLOT_SIZE) + 3U;
+    atomic_val_t pos;
+    uint32_t count;
+
+    zassert_ok(prv_push(len, 2U), "push failed");
+
+    zassert_true(ovyl_log_storage_ring_claim(&test_ring, &pos, &count), "claim failed");
+    zassert_equal(count, 3U, "message should span three slots");
+    zassert_equal(ovyl_log_storage_ring_slot(&test_ring, pos + 2)->len, 3U, "wrong tail length");
+    ovyl_log_storage_ring_release(&test_ring, pos, count);
+
+    zassert_ok(prv_push(len, 3U), "push after release failed");
+    prv_expect(len, 3U);
+}
+
+ZTEST(log_storage_ring, test_fifo_order)
+{
+    for (uint8_t i = 0; i < 3U; i++) {
+        zassert_ok(prv_push(SLOT_SIZE + i, i), "push %u failed", i);
+    }
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        prv_expect(SLOT_SIZE + i, i);
+    }
+}
+
+ZTEST(log_storage_ring, test_wrap)
+{
+    /* Messages of three slots never line up with the end of the ring. */
+    for (uint8_t i = 0; i < (4U * RING_SLOTS); i++) {
+        zassert_ok(prv_push((2U * SLOT_SIZE) + 1U, i), "push %u failed", i);
+        prv_expect((2U * SLOT_SIZE) + 1U, i);
+    }
+}
+
+ZTEST(log_storage_ring, test_position_counter_wrap)
+{
+    prv_ring_start_at((atomic_val_t)(uint32_t)(UINT32_MAX - 2U));
+
+    for (uint8_t i = 0; i < 4U; i++) {
+        zassert_ok(prv_push(SLOT_SIZE * 2U, i), "push %u failed", i);
+        prv_expect(SLOT_SIZE * 2U, i);
+    }
+}
+
+ZTEST(log_storage_ring, test_oversize)
+{
+    zassert_equal(prv_push(RING_BYTES + 1U, 0U), -EMSGSIZE, "oversize message accepted");
+    zassert_equal(atomic_get(&test_ring.dropped), 1, "oversize message not counted");
+
+    zassert_ok(prv_push(RING_BYTES, 1U), "message filling the ring rejected");
+    prv_expect(RING_BYTES, 1U);
+}
+
+ZTEST(log_storage_ring, test_full)
+{
+    for (uint8_t i = 0; i < RING_SLOTS; i++) {
+        zassert_ok(prv_push(SLOT_SIZE, i), "push %u failed", i);
+    }
+
+    int ret = prv_push(SLOT_SIZE, RING_SLOTS);
+
+    zassert_equal(atomic_get(&test_ring.dropped), 1, "overflow not counted");
+
+    if (IS_ENABLED(CONFIG_OVYL_LOG_STORAGE_ASYNC_DROP_OLDEST)) {
+        zassert_ok(ret, "newest message not queued");
+        for (uint8_t i = 1; i <= RING_SLOTS; i++) {
+            prv_expect(SLOT_SIZE, i);
+        }
+    } else {
+        zassert_equal(ret, -ENOMEM, "newest message not dropped");
+        for (uint8_t i = 0; i < RING_SLOTS; i++) {
+            prv_expect(SLOT_SIZE, i);
+        }
+    }
+
+    zassert_equal(prv_pop(NULL, 0U), -1, "ring not empty");
+}
+
+ZTEST(log_storage_ring, test_full_multi_slot)
+{
+    /* Room for one more slot, but not for the two the new message needs. */
+    for (uint8_t i = 0; i < (RING_SLOTS - 1U); i++) {
+        zassert_ok(prv_push(SLOT_SIZE, i), "push %u failed", i);
+    }
+
+    int ret = prv_push(SLOT_SIZE + 1U, 0xA0U);
+
+    if (IS_ENABLED(CONFIG_OVYL_LOG_STORAGE_ASYNC_DROP_OLDEST)) {
+        zassert_ok(ret, "newest message not queued");
+        for (uint8_t i = 1; i < (RING_SLOTS - 1U); i++) {
+            prv_expect(SLOT_SIZE, i);
+        }
+        prv_expect(SLOT_SIZE + 1U, 0xA0U);
+    } else {
+        zassert_equal(ret, -ENOMEM, "newest message not dropped");
+        for (uint8_t i = 0; i < (RING_SLOTS - 1U); i++) {
+            prv_expect(SLOT_SIZE, i);
+        }
+    }
+
+    zassert_equal(atomic_get(&test_ring.dropped), 1, "overflow not counted");
+}
+
+ZTEST(log_storage_ring, test_claimed_message_kept)
+{
+    atomic_val_t pos;
+    uint32_t count;
+
+    for (uint8_t i = 0; i < RING_SLOTS; i++) {
+        zassert_ok(prv_push(SLOT_SIZE, i), "push %u failed", i);
+    }
+
+    /* A consumer still copying the oldest message out holds its slot. */
+    zassert_true(ovyl_log_storage_ring_claim(&test_ring, &pos, &count), "claim failed");
+
+    int ret = prv_push(SLOT_SIZE, 0xB0U);
+
+    zassert_equal(ret, -ENOMEM, "slot of a claimed message reused");
+    zassert_equal(ovyl_log_storage_ring_slot(&test_ring, pos)->data[0], 0U, "claimed message overwritten");
+
+    ovyl_log_storage_ring_release(&test_ring, pos, count);
+    zassert_ok(prv_push(SLOT_SIZE, 0xB1U), "push after release failed");
+}
+
+ZTEST(log_storage_ring, test_high_water)
+{
+    for (uint8_t i = 0; i < 3U; i++) {
+        zassert_ok(prv_push(SLOT_SIZE, i), "push %u failed", i);
+    }
+
+    zassert_equal(atomic_get(&test_ring.high_water), 3, "high water not tracked");
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        prv_expect(SLOT_SIZE, i);
+    }
+
+    zassert_ok(prv_push(SLOT_SIZE, 0U), "push failed");
+    zassert_equal(atomic_get(&test_ring.high_water), 3, "high water went down");
+}
+
+ZTEST_SUITE(log_storage_ring, NULL, NULL, ring_before, NULL, NULL);